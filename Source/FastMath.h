@@ -0,0 +1,101 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// Polynomial replacements for the libm calls left on SWAY's float paths: the
+// LFO rate mapping (once per control interval) and the warmth stage (tanh in
+// HQ, log-cosh and tanh in Eco, per sample). The LFO shapes and phaser
+// coefficients are tables, so nothing else needs them.
+//
+// Scalar and not constexpr: the bit cast in exp2() needs memcpy in C++17, and
+// every caller passes one value at a time. They avoid libm entirely (floor is
+// a call on baseline x86-64); min/max and truncating casts are single
+// instructions. The bounds below are measured against the std versions in
+// double precision over the ranges the plugin feeds in (sway_bench --verify).
+namespace FastMath
+{
+    // Maximum relative error of exp2() for x in [-126, 127]
+    inline constexpr float kExp2MaxRelError = 1.5e-7f;
+
+    // Maximum absolute error of tanh() over all finite x
+    inline constexpr float kTanhMaxError = 2.0e-7f;
+
+    // Maximum absolute error of logCosh() for |x| <= 40; above |x| = 4 it is
+    // the rounding of the result itself
+    inline constexpr float kLogCoshMaxError = 2.0e-6f;
+
+    namespace detail
+    {
+        // Evaluates c[0] + c[1] x + ... + c[N-1] x^(N-1)
+        template <size_t N>
+        constexpr float horner(float x, const float (&c)[N])
+        {
+            float y = c[N - 1];
+            for (size_t i = N - 1; i > 0; --i)
+                y = y * x + c[i - 1];
+            return y;
+        }
+    }
+
+    // Fractional part in [0, 1). Phases stay far below the point where float
+    // loses its fraction, so this is exact.
+    inline float wrap(float x)
+    {
+        return x - std::floor(x);
+    }
+
+    // 2^x with a degree-6 polynomial on [-0.5, 0.5] (Cephes exp2f) and the
+    // integer part placed directly in the exponent bits.
+    inline float exp2(float x)
+    {
+        constexpr float c[] = { 1.0f, 6.931472028550421e-1f, 2.402264791363012e-1f,
+                                5.550332471162809e-2f, 9.618437357674640e-3f,
+                                1.339887440266574e-3f, 1.535336188319500e-4f };
+
+        // Rounds through a positive int, where truncation is floor: no libm call
+        x = std::min(127.0f, std::max(-126.0f, x));
+        const auto biased = static_cast<std::int32_t>(x + 127.5f);    // round(x) + 127
+        const float p = detail::horner(x - static_cast<float>(biased - 127), c);
+
+        const auto bits = static_cast<std::uint32_t>(biased) << 23;
+        float scale;
+        std::memcpy(&scale, &bits, sizeof(scale));
+        return p * scale;
+    }
+
+    // Hyperbolic tangent from exp2: (e^2x - 1) / (e^2x + 1). Inputs are clamped
+    // to +-9, beyond which tanh rounds to +-1 in float.
+    inline float tanh(float x)
+    {
+        constexpr float twoLog2e = 2.8853900817779268f;
+
+        x = std::min(9.0f, std::max(-9.0f, x));
+        const float e = FastMath::exp2(x * twoLog2e);
+        return (e - 1.0f) / (e + 1.0f);
+    }
+
+    // log(cosh(x)), the antiderivative of tanh. Near zero the closed form
+    // |x| + log1p(e^-2|x|) - log(2) cancels, so the Taylor series takes over
+    // below |x| = 1/4. log1p(e) is 2 atanh(e / (2 + e)), whose argument stays
+    // in (0, 1/3] where the odd series converges fast.
+    inline float logCosh(float x)
+    {
+        constexpr float ln2 = 0.6931471805599453f;
+        constexpr float minusTwoLog2e = -2.8853900817779268f;
+        constexpr float atanhSeries[] = { 2.0f, 2.0f / 3.0f, 2.0f / 5.0f, 2.0f / 7.0f,
+                                          2.0f / 9.0f, 2.0f / 11.0f, 2.0f / 13.0f };
+        constexpr float taylor[] = { 0.5f, -1.0f / 12.0f, 1.0f / 45.0f, -17.0f / 2520.0f, 31.0f / 14175.0f };
+
+        const float a = std::abs(x);
+        const float e = FastMath::exp2(a * minusTwoLog2e);
+        const float s = e / (2.0f + e);
+        const float closed = a + s * detail::horner(s * s, atanhSeries) - ln2;
+
+        const float x2 = x * x;
+        const float series = x2 * detail::horner(x2, taylor);
+        return a < 0.25f ? series : closed;
+    }
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <cmath>
+
+// One LFO cycle as an interpolated wavetable, read with 32-bit integer phases.
+//
+// A Phase counts 2^32 steps per cycle, so accumulators wrap exactly, offsets
+// are plain additions, and no precision is lost however long a render runs.
+// The top kIndexBits of a phase pick a table entry and the rest interpolate
+// linearly towards the next (sine error < 4e-7). Any single-cycle function can
+// be tabulated, so a drawn shape would cost the same as the built-in ones.
+class LfoWavetable
+{
+public:
+    using Phase = juce::uint32;
+
+    enum Shape { sine = 0, triangle, square };
+    static constexpr int kNumShapes = 3;
+
+    static constexpr int kIndexBits = 12;
+    static constexpr int kSize = 1 << kIndexBits;
+
+    // Highest harmonic of the softened triangle and square
+    static constexpr int kHarmonics = 31;
+
+    // Cycles (any value) to a phase, wrapped into one cycle
+    static Phase toPhase(double cycles)
+    {
+        return static_cast<Phase>(static_cast<juce::uint64>(std::llround((cycles - std::floor(cycles)) * kCycle)));
+    }
+
+    static float toCycles(Phase phase)
+    {
+        return static_cast<float>(static_cast<double>(phase) / kCycle);
+    }
+
+    // Exact value (-1 to 1) of a built-in shape at `cycles`. Triangle and square
+    // are band-limited to kHarmonics with Fejer weights, which rounds the
+    // corners and turns the square's step into a short glide without overshoot.
+    // Slow; the tables are sampled from it.
+    static double evaluate(int shape, double cycles)
+    {
+        constexpr double twoPi = juce::MathConstants<double>::twoPi;
+
+        if (shape == sine)
+            return std::sin(twoPi * cycles);
+
+        // Partial sums over the odd harmonics, normalized to reach exactly 1
+        // at the peak (phase 0 for the triangle, 0.25 for the square)
+        double sum = 0.0, peak = 0.0;
+
+        for (int k = 1; k <= kHarmonics; k += 2)
+        {
+            const double weight = 1.0 - static_cast<double>(k) / (kHarmonics + 1);
+
+            if (shape == triangle)
+            {
+                sum += weight * std::cos(twoPi * k * cycles) / (k * k);
+                peak += weight / (k * k);
+            }
+            else
+            {
+                sum += weight * std::sin(twoPi * k * cycles) / k;
+                peak += weight * ((k / 2) % 2 == 0 ? 1.0 : -1.0) / k;
+            }
+        }
+
+        return juce::jlimit(-1.0, 1.0, sum / peak);
+    }
+
+    // The built-in tables, shared by every engine and built on first use
+    static const LfoWavetable& get(int shape)
+    {
+        static const std::array<LfoWavetable, kNumShapes> tables {
+            LfoWavetable([](double c) { return evaluate(sine, c); }),
+            LfoWavetable([](double c) { return evaluate(triangle, c); }),
+            LfoWavetable([](double c) { return evaluate(square, c); })
+        };
+        return tables[static_cast<size_t>(juce::jlimit(0, kNumShapes - 1, shape))];
+    }
+
+    // Tabulates shapeFunction(cycles) over one cycle
+    template <typename ShapeFunction>
+    explicit LfoWavetable(ShapeFunction&& shapeFunction)
+    {
+        for (int i = 0; i < kSize; ++i)
+            values[static_cast<size_t>(i)] = static_cast<float>(shapeFunction(static_cast<double>(i) / kSize));
+
+        // Guard point so the last entry interpolates towards the start of the cycle
+        values[kSize] = values[0];
+    }
+
+    float read(Phase phase) const
+    {
+        const auto index = static_cast<size_t>(phase >> kFractionBits);
+        const float fraction = static_cast<float>(phase & kFractionMask) * kFractionScale;
+        const float a = values[index];
+        return a + (values[index + 1] - a) * fraction;
+    }
+
+    // out[i] = read(base + offsets[i]): every voice of one channel in one pass
+    void read(Phase base, const Phase* offsets, float* out, int count) const
+    {
+        for (int i = 0; i < count; ++i)
+            out[i] = read(base + offsets[i]);
+    }
+
+private:
+    static constexpr double kCycle = 4294967296.0;
+    static constexpr int kFractionBits = 32 - kIndexBits;
+    static constexpr Phase kFractionMask = (Phase(1) << kFractionBits) - 1;
+    static constexpr float kFractionScale = 1.0f / static_cast<float>(Phase(1) << kFractionBits);
+
+    std::array<float, kSize + 1> values {};
+};
@@ -0,0 +1,215 @@
+#include "ModulationEngine.h"
+
+ModulationEngine::ModulationEngine()
+    : sineTable(LfoWavetable::get(LfoWavetable::sine)),
+      triangleTable(LfoWavetable::get(LfoWavetable::triangle)),
+      squareTable(LfoWavetable::get(LfoWavetable::square)),
+      sessionSeed(static_cast<juce::uint32>(juce::Random::getSystemRandom().nextInt()) | 1u)
+{
+}
+
+void ModulationEngine::prepare(double newSampleRate, int newControlInterval)
+{
+    sampleRate = newSampleRate;
+    phaserCoefficients.prepare(sampleRate);
+    controlInterval = juce::jlimit(1, kMaxControlInterval, newControlInterval);
+
+    random.prepare(sampleRate);
+    randomSmoothing = random.getSmoothing(controlInterval);
+
+    reset();
+}
+
+void ModulationEngine::reset()
+{
+    masterPhase = 0;
+    lfoPhase[0] = phaseOffset;
+    lfoPhase[1] = 0;
+    random.reset(seed != 0 ? seed : sessionSeed, stream);
+
+    for (auto* ramps : { &delaySamples, &delayIncrement, &delayTarget })
+        for (auto& ch : *ramps)
+            ch.fill(0.0f);
+
+    for (auto* ramps : { &coefficient, &coefficientIncrement, &coefficientTarget })
+        for (auto& ch : *ramps)
+            ch.fill(0.0f);
+
+    primed = false;
+}
+
+void ModulationEngine::prepareSettings(Settings& settings) const
+{
+    const float msToSamples = static_cast<float>(sampleRate) / 1000.0f;
+
+    // The shortest tap stays at least one sample behind the write head at any
+    // rate (the flanger's 0.1 ms floor is under a sample below 10 kHz), so the
+    // cubic and allpass reads always have their near neighbour written.
+    const float minDelaySamples = std::max(settings.minDelayMs * msToSamples, 1.0f);
+    const float maxDelaySamples = std::max(settings.maxDelayMs * msToSamples, minDelaySamples);
+
+    settings.delayCentreSamples = (minDelaySamples + maxDelaySamples) * 0.5f;
+    settings.delayHalfRangeSamples = (maxDelaySamples - minDelaySamples) * 0.5f;
+    settings.stereoOffset = LfoWavetable::toPhase(settings.stereoPhase);
+
+    // Voices spread evenly over the cycle, scaled by spread
+    const int numVoices = juce::jlimit(1, kMaxVoices, settings.numVoices);
+    for (int v = 0; v < kMaxVoices; ++v)
+        settings.voiceOffset[static_cast<size_t>(v)] = v < numVoices
+            ? LfoWavetable::toPhase(static_cast<float>(v) / static_cast<float>(numVoices) * settings.spread)
+            : 0;
+}
+
+template <int Shape>
+float ModulationEngine::getShapeValue(LfoWavetable::Phase phase, int channel) const
+{
+    if constexpr (Shape == 1) return triangleTable.read(phase);
+    else if constexpr (Shape == 2) return squareTable.read(phase);
+    else if constexpr (Shape == 3) return random.getValue(channel);
+    else return sineTable.read(phase);
+}
+
+float ModulationEngine::getLfoValue(int shape, int channel) const
+{
+    switch (shape)
+    {
+        case 1:  return getShapeValue<1>(lfoPhase[channel], channel);
+        case 2:  return getShapeValue<2>(lfoPhase[channel], channel);
+        case 3:  return getShapeValue<3>(lfoPhase[channel], channel);
+        default: return getShapeValue<0>(lfoPhase[channel], channel);
+    }
+}
+
+void ModulationEngine::advanceRandom(int numSamples)
+{
+    const float smoothing = numSamples == controlInterval ? randomSmoothing : random.getSmoothing(numSamples);
+
+    for (int ch = 0; ch < 2; ++ch)
+        random.advance(ch, LfoWavetable::toCycles(lfoPhase[ch]), smoothing);
+}
+
+float ModulationEngine::getLfoIncrement(float rate) const
+{
+    // LFO rate: 0.01 to 20 Hz (exponential mapping, 0.01 * 2000^(rate/100))
+    constexpr float log2Of2000 = 10.965784284662087f;
+    const float lfoFreq = 0.01f * FastMath::exp2(rate / 100.0f * log2Of2000);
+    return lfoFreq / static_cast<float>(sampleRate);
+}
+
+void ModulationEngine::advancePhase(const Settings& settings, float lfoInc, int numSamples)
+{
+    // Update LFO phases with stereo offset. The master phase keeps 32 bits
+    // below the table phase, so rounding the step never adds up to a rate
+    // error, and wrapping is free.
+    constexpr double fixedPointCycle = 18446744073709551616.0;   // 2^64
+    masterPhase += static_cast<juce::uint64>(static_cast<double>(lfoInc) * numSamples * fixedPointCycle);
+    lfoPhase[0] = static_cast<LfoWavetable::Phase>(masterPhase >> 32) + phaseOffset;
+    lfoPhase[1] = lfoPhase[0] + settings.stereoOffset;
+}
+
+void ModulationEngine::skip(const Settings& settings, float rate, int shape, int numSamples)
+{
+    // One interval's worth of phase per step keeps the fixed-point product in range
+    const float lfoInc = getLfoIncrement(rate);
+    for (int remaining = numSamples; remaining > 0; remaining -= controlInterval)
+        advancePhase(settings, lfoInc, juce::jmin(remaining, controlInterval));
+
+    if (shape == 3)
+        advanceRandom(numSamples);
+
+    primed = false;
+}
+
+template <bool IsPhaser, int Shape, int NumChannels>
+void ModulationEngine::computeTargets(const Settings& settings, float depth, LfoWavetable::Phase lfoStep)
+{
+    if constexpr (IsPhaser)
+    {
+        phaserCoefficients.setNumStages(settings.numStages);
+
+        for (int ch = 0; ch < NumChannels; ++ch)
+            phaserCoefficients.computeCoefficients(getShapeValue<Shape>(lfoPhase[ch], ch), depth,
+                                                   settings.minFreq, settings.maxFreq,
+                                                   coefficientTarget[ch].data());
+    }
+    else
+    {
+        // Voices read the phase after this sample's increment
+        LfoWavetable::Phase phase[2];
+        phase[0] = lfoPhase[0] + lfoStep;
+        phase[1] = phase[0] + settings.stereoOffset;
+
+        const int numVoices = juce::jlimit(1, kMaxVoices, settings.numVoices);
+        const float swing = settings.delayHalfRangeSamples * depth;
+
+        for (int ch = 0; ch < NumChannels; ++ch)
+        {
+            // Every voice's offset phase in one pass over the table
+            float voiceLfo[kMaxVoices];
+            sineTable.read(phase[ch], settings.voiceOffset.data(), voiceLfo, numVoices);
+
+            for (int v = 0; v < numVoices; ++v)
+                delayTarget[ch][v] = settings.delayCentreSamples + voiceLfo[v] * swing;
+        }
+    }
+}
+
+template <bool IsPhaser, int Shape, int NumChannels>
+void ModulationEngine::advance(const Settings& settings, float rate, float depth, int numSamples)
+{
+    jassert(numSamples > 0 && numSamples <= controlInterval);
+
+    const float lfoInc = getLfoIncrement(rate);
+    const auto lfoStep = LfoWavetable::toPhase(lfoInc);
+
+    if (! primed)
+    {
+        lfoPhase[1] = lfoPhase[0] + settings.stereoOffset;
+
+        // The first control point sees the random LFO at phase 0 like any other
+        if constexpr (Shape == 3)
+            advanceRandom(1);
+
+        computeTargets<IsPhaser, Shape, NumChannels>(settings, depth, lfoStep);
+        primed = true;
+    }
+
+    // Ramps start where the previous interval ended
+    delaySamples = delayTarget;
+    coefficient = coefficientTarget;
+
+    advancePhase(settings, lfoInc, numSamples);
+
+    if constexpr (Shape == 3)
+        advanceRandom(numSamples);
+
+    computeTargets<IsPhaser, Shape, NumChannels>(settings, depth, lfoStep);
+
+    const float invLength = 1.0f / static_cast<float>(numSamples);
+
+    for (int ch = 0; ch < NumChannels; ++ch)
+    {
+        for (int v = 0; v < kMaxVoices; ++v)
+            delayIncrement[ch][v] = (delayTarget[ch][v] - delaySamples[ch][v]) * invLength;
+
+        for (int s = 0; s < kMaxStages; ++s)
+            coefficientIncrement[ch][s] = (coefficientTarget[ch][s] - coefficient[ch][s]) * invLength;
+    }
+}
+
+template void ModulationEngine::advance<false, 0, 1>(const Settings&, float, float, int);
+template void ModulationEngine::advance<false, 1, 1>(const Settings&, float, float, int);
+template void ModulationEngine::advance<false, 2, 1>(const Settings&, float, float, int);
+template void ModulationEngine::advance<false, 3, 1>(const Settings&, float, float, int);
+template void ModulationEngine::advance<true, 0, 1>(const Settings&, float, float, int);
+template void ModulationEngine::advance<true, 1, 1>(const Settings&, float, float, int);
+template void ModulationEngine::advance<true, 2, 1>(const Settings&, float, float, int);
+template void ModulationEngine::advance<true, 3, 1>(const Settings&, float, float, int);
+template void ModulationEngine::advance<false, 0, 2>(const Settings&, float, float, int);
+template void ModulationEngine::advance<false, 1, 2>(const Settings&, float, float, int);
+template void ModulationEngine::advance<false, 2, 2>(const Settings&, float, float, int);
+template void ModulationEngine::advance<false, 3, 2>(const Settings&, float, float, int);
+template void ModulationEngine::advance<true, 0, 2>(const Settings&, float, float, int);
+template void ModulationEngine::advance<true, 1, 2>(const Settings&, float, float, int);
+template void ModulationEngine::advance<true, 2, 2>(const Settings&, float, float, int);
+template void ModulationEngine::advance<true, 3, 2>(const Settings&, float, float, int);
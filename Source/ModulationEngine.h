@@ -0,0 +1,127 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include "PhaserCoefficients.h"
+#include "LfoWavetable.h"
+#include "RandomModulator.h"
+#include "FastMath.h"
+
+// Control-rate modulation source for SWAY.
+//
+// LFO values, voice delay times and phaser allpass coefficients are evaluated
+// once per control interval and handed to the audio loop as linear ramps
+// (value + per-sample increment), so the per-sample path only has to add.
+// LFO phases are 32-bit integers read through LfoWavetable.
+class ModulationEngine
+{
+public:
+    static constexpr int kMaxVoices = 8;
+    static constexpr int kMaxStages = PhaserCoefficientGenerator::kMaxStages;
+    static constexpr int kDefaultControlInterval = 16;
+    static constexpr int kMaxControlInterval = 64;
+
+    struct Settings
+    {
+        float stereoPhase = 0.0f;   // R channel offset in cycles (0-0.5)
+
+        // Chorus / Flanger / Ensemble
+        int numVoices = 1;
+        float spread = 0.0f;
+        float minDelayMs = 7.0f;
+        float maxDelayMs = 30.0f;
+
+        // Phaser
+        int numStages = 6;
+        float minFreq = 200.0f;
+        float maxFreq = 4000.0f;
+
+        // Derived by prepareSettings() from the fields above
+        float delayCentreSamples = 0.0f;
+        float delayHalfRangeSamples = 0.0f;
+        LfoWavetable::Phase stereoOffset = 0;
+        std::array<LfoWavetable::Phase, kMaxVoices> voiceOffset {};    // per voice, spread applied
+    };
+
+    ModulationEngine();
+
+    void prepare(double sampleRate, int controlInterval);
+    void reset();
+
+    // Seed for the Random shape, applied on every reset(). 0 uses the
+    // nondeterministic seed picked at construction. Engines given the same seed
+    // and different streams draw independent sequences.
+    void setSeed(juce::uint32 newSeed, int newStream = 0) { seed = newSeed; stream = newStream; }
+
+    // Starting point of the L LFO in cycles (0-1), applied on every reset().
+    // Lets several engines run the same LFO rotated around the cycle.
+    void setPhaseOffset(float cycles) { phaseOffset = LfoWavetable::toPhase(cycles); }
+
+    int getControlInterval() const { return controlInterval; }
+
+    // Fills in the derived members of settings for the prepared sample rate.
+    // Call after changing any other member, and again after prepare().
+    void prepareSettings(Settings& settings) const;
+    float getLfoPhase(int channel = 0) const { return LfoWavetable::toCycles(lfoPhase[channel]); }
+
+    // LFO output (-1 to 1) for a runtime shape; for the visualizer, not the audio path
+    float getLfoValue(int shape, int channel) const;
+
+    // Moves the LFO forward by numSamples (at most one control interval) and
+    // sets up ramps that reach the next control point after numSamples steps.
+    // rate is the raw 0-100 parameter value, depth is 0-1. Shape is the LFO
+    // shape (0=Sine, 1=Triangle, 2=Square, 3=Random), which only the phaser uses.
+    // With NumChannels == 1 only the L ramps are updated. Instantiated in
+    // ModulationEngine.cpp for every mode/shape/channel-count combination.
+    template <bool IsPhaser, int Shape, int NumChannels>
+    void advance(const Settings& settings, float rate, float depth, int numSamples);
+
+    // Moves the LFO forward by any number of samples without computing ramps,
+    // for blocks the processor skips while idle. The random LFO draws at most
+    // one new target per call. The next advance() starts its ramps from the
+    // phase reached here.
+    void skip(const Settings& settings, float rate, int shape, int numSamples);
+
+    // Per-channel ramps. Read the current value, then add the increment once per sample.
+    // Voice ramps are SIMD-aligned so the voice kernel can load them directly.
+    static constexpr size_t kAlignment = juce::dsp::SIMDRegister<float>::SIMDRegisterSize;
+    alignas(kAlignment) std::array<std::array<float, kMaxVoices>, 2> delaySamples {};
+    alignas(kAlignment) std::array<std::array<float, kMaxVoices>, 2> delayIncrement {};
+    std::array<std::array<float, kMaxStages>, 2> coefficient {}, coefficientIncrement {};
+
+private:
+    template <bool IsPhaser, int Shape, int NumChannels>
+    void computeTargets(const Settings& settings, float depth, LfoWavetable::Phase lfoStep);
+
+    template <int Shape>
+    float getShapeValue(LfoWavetable::Phase phase, int channel) const;
+
+    void advanceRandom(int numSamples);
+    float getLfoIncrement(float rate) const;
+    void advancePhase(const Settings& settings, float lfoInc, int numSamples);
+
+    double sampleRate = 44100.0;
+    int controlInterval = kDefaultControlInterval;
+    bool primed = false;
+
+    PhaserCoefficientGenerator phaserCoefficients;
+
+    // Control point values the ramps are heading towards
+    std::array<std::array<float, kMaxVoices>, 2> delayTarget {};
+    std::array<std::array<float, kMaxStages>, 2> coefficientTarget {};
+
+    // LFO state
+    const LfoWavetable& sineTable;
+    const LfoWavetable& triangleTable;
+    const LfoWavetable& squareTable;
+    juce::uint64 masterPhase = 0;   // 32.32 fixed point: the phase, then the sub-step remainder
+    LfoWavetable::Phase phaseOffset = 0;
+    LfoWavetable::Phase lfoPhase[2] = { 0, 0 };
+    RandomModulator random;
+    juce::uint32 seed = 0;
+    int stream = 0;
+    juce::uint32 sessionSeed = 0;
+    float randomSmoothing = 0.0f;   // glide step covering a full control interval
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ModulationEngine)
+};
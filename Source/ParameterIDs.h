@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+
 namespace ParameterIDs
 {
     // === MODULATION TYPE ===
@@ -16,6 +18,8 @@ namespace ParameterIDs
     inline constexpr const char* voices       = "voices";       // Number of voices (1-8)
     inline constexpr const char* spread       = "spread";       // Voice spread/detune (0-100%)
     inline constexpr const char* warmth       = "warmth";       // Analog warmth/saturation (0-100%)
+    inline constexpr const char* warmthQuality = "warmthQuality"; // Saturation quality (0=Eco, 1=HQ 2x, 2=HQ 4x)
+    inline constexpr const char* interpolation = "interpolation"; // Delay tap interpolation (0=Linear, 1=Cubic, 2=Allpass, flanger only)
 
     // === FILTER (for phaser) ===
     inline constexpr const char* stages       = "stages";       // Phaser stages (2-12)
@@ -26,6 +30,12 @@ namespace ParameterIDs
     inline constexpr const char* width        = "width";        // Stereo width (0-200%)
     inline constexpr const char* bypass       = "bypass";       // Master bypass
 
+    // Every parameter, in the order the editor streams them to the web UI
+    inline constexpr std::array<const char*, 16> all {
+        mode, rate, depth, shape, stereoPhase, feedback, voices, spread,
+        warmth, warmthQuality, interpolation, stages, color, mix, width, bypass
+    };
+
     namespace Ranges
     {
         // Rate: 0.01 - 20 Hz (normalized 0-100)
@@ -66,6 +76,12 @@ namespace ParameterIDs
         inline constexpr float warmthMax = 100.0f;
         inline constexpr float warmthDefault = 20.0f;
 
+        // Warmth quality: 0=Eco (ADAA), 1=HQ 2x, 2=HQ 4x oversampled
+        inline constexpr int warmthQualityDefault = 0;
+
+        // Interpolation: 0=Linear (eco), 1=Cubic (4-point Hermite), 2=Allpass (flanger)
+        inline constexpr int interpolationDefault = 0;
+
         // Stages: 2-12
         inline constexpr float stagesMin = 2.0f;
         inline constexpr float stagesMax = 12.0f;
@@ -0,0 +1,152 @@
+#include "ParameterStream.h"
+
+ParameterStream::ParameterStream(juce::AudioProcessorValueTreeState& apvts)
+{
+    for (int i = 0; i < kNumParameters; ++i)
+    {
+        auto* parameter = apvts.getParameter(ParameterIDs::all[static_cast<size_t>(i)]);
+        jassert(parameter != nullptr);
+
+        parameters[static_cast<size_t>(i)] = parameter;
+
+        const int processorIndex = parameter->getParameterIndex();
+        if (processorIndex >= static_cast<int>(indexForProcessorIndex.size()))
+            indexForProcessorIndex.resize(static_cast<size_t>(processorIndex) + 1, -1);
+        indexForProcessorIndex[static_cast<size_t>(processorIndex)] = i;
+
+        dirty[static_cast<size_t>(i)].store(true, std::memory_order_relaxed);
+        parameter->addListener(this);
+    }
+
+    anyDirty.store(true, std::memory_order_release);
+    packed.reserve(static_cast<size_t>(kHeaderSize + kNumParameters * kFrameStride));
+}
+
+ParameterStream::~ParameterStream()
+{
+    for (size_t i = 0; i < parameters.size(); ++i)
+    {
+        // A drag cut short by the editor closing must not leave the host mid-gesture
+        if (uiGesture[i])
+            parameters[i]->endChangeGesture();
+
+        parameters[i]->removeListener(this);
+    }
+}
+
+void ParameterStream::resendAll()
+{
+    for (auto& flag : dirty)
+        flag.store(true, std::memory_order_relaxed);
+
+    anyDirty.store(true, std::memory_order_release);
+    layoutPending = true;
+}
+
+juce::var ParameterStream::takeLayout()
+{
+    juce::Array<juce::var> layout;
+
+    for (size_t i = 0; i < parameters.size(); ++i)
+    {
+        const auto& range = parameters[i]->getNormalisableRange();
+
+        juce::DynamicObject::Ptr entry = new juce::DynamicObject();
+        entry->setProperty("id", juce::String(ParameterIDs::all[i]));
+        entry->setProperty("min", range.start);
+        entry->setProperty("max", range.end);
+        layout.add(juce::var(entry.get()));
+    }
+
+    layoutPending = false;
+    return layout;
+}
+
+juce::String ParameterStream::takePayload()
+{
+    anyDirty.store(false, std::memory_order_release);
+
+    packed.clear();
+    packed.push_back(static_cast<float>(kLayoutVersion));
+    packed.push_back(static_cast<float>(kFrameStride));
+
+    for (size_t i = 0; i < parameters.size(); ++i)
+    {
+        if (! dirty[i].exchange(false, std::memory_order_acq_rel))
+            continue;
+
+        // Read now rather than when marked, so the UI gets the newest value
+        auto* parameter = parameters[i];
+        packed.push_back(static_cast<float>(i));
+        packed.push_back(parameter->convertFrom0to1(parameter->getValue()));
+    }
+
+    if (packed.size() == static_cast<size_t>(kHeaderSize))
+        return {};
+
+    // Every supported target is little-endian, which is what Float32Array reads
+    return juce::Base64::toBase64(packed.data(), packed.size() * sizeof(float));
+}
+
+void ParameterStream::handleChange(const juce::var& data)
+{
+    const int index = indexOf(data.getProperty("id", {}).toString());
+    if (index < 0)
+        return;
+
+    const auto slot = static_cast<size_t>(index);
+    auto* parameter = parameters[slot];
+    const float value = parameter->convertTo0to1(static_cast<float>(data.getProperty("value", 0.0)));
+
+    // Clicks on choices and toggles arrive without a gesture of their own
+    if (! uiGesture[slot])
+        parameter->beginChangeGesture();
+
+    parameter->setValueNotifyingHost(value);
+
+    if (! uiGesture[slot])
+        parameter->endChangeGesture();
+}
+
+void ParameterStream::handleGesture(const juce::var& data)
+{
+    const int index = indexOf(data.getProperty("id", {}).toString());
+    if (index < 0)
+        return;
+
+    const auto slot = static_cast<size_t>(index);
+    const bool begin = data.getProperty("begin", false);
+
+    if (begin == uiGesture[slot])
+        return;
+
+    uiGesture[slot] = begin;
+
+    if (begin)
+        parameters[slot]->beginChangeGesture();
+    else
+        parameters[slot]->endChangeGesture();
+}
+
+void ParameterStream::parameterValueChanged(int parameterIndex, float)
+{
+    // Can run on the audio thread: only flag the change
+    if (parameterIndex < 0 || parameterIndex >= static_cast<int>(indexForProcessorIndex.size()))
+        return;
+
+    const int index = indexForProcessorIndex[static_cast<size_t>(parameterIndex)];
+    if (index < 0)
+        return;
+
+    dirty[static_cast<size_t>(index)].store(true, std::memory_order_relaxed);
+    anyDirty.store(true, std::memory_order_release);
+}
+
+int ParameterStream::indexOf(const juce::String& id) const
+{
+    for (int i = 0; i < kNumParameters; ++i)
+        if (id == ParameterIDs::all[static_cast<size_t>(i)])
+            return i;
+
+    return -1;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <array>
+#include <atomic>
+#include <vector>
+#include "ParameterIDs.h"
+
+// One batched parameter channel between the processor and the web UI, built
+// from ParameterIDs::all rather than a relay and attachment per parameter.
+//
+// Host -> UI: changes only mark their parameter dirty (any thread, lock-free).
+// Once per UI frame the editor takes a payload holding every parameter that
+// changed since the last one, so dense automation costs one message per frame
+// instead of one per change. The payload is base64 of little-endian Float32
+// values, read by readFloat32Frames in web-ui/src/lib/juce-bridge.ts: a header
+// { kLayoutVersion, kFrameStride } followed by { index, value } frames, where
+// index is the position in ParameterIDs::all and value is in the parameter's
+// own units. The UI maps indices to IDs with the "parameterLayout" message.
+//
+// UI -> host: "parameterChange" { id, value } and "parameterGesture" { id, begin }.
+class ParameterStream : private juce::AudioProcessorParameter::Listener
+{
+public:
+    static constexpr int kLayoutVersion = 1;
+    static constexpr int kHeaderSize = 2;
+    static constexpr int kFrameStride = 2;
+    static constexpr int kNumParameters = static_cast<int>(ParameterIDs::all.size());
+
+    explicit ParameterStream(juce::AudioProcessorValueTreeState& apvts);
+    ~ParameterStream() override;
+
+    // Message thread. Resends the layout and every value with the next payload,
+    // for a page that has just loaded or was showing another instance.
+    void resendAll();
+
+    // Message thread. The { id, min, max } table for "parameterLayout", once per resendAll()
+    bool isLayoutPending() const { return layoutPending; }
+    juce::var takeLayout();
+
+    bool hasPendingChanges() const { return anyDirty.load(std::memory_order_acquire); }
+
+    // Message thread. Encodes the dirty parameters and clears them
+    juce::String takePayload();
+
+    // Message thread, from the UI's events
+    void handleChange(const juce::var& data);
+    void handleGesture(const juce::var& data);
+
+private:
+    void parameterValueChanged(int parameterIndex, float newValue) override;
+    void parameterGestureChanged(int, bool) override {}
+
+    int indexOf(const juce::String& id) const;
+
+    std::array<juce::RangedAudioParameter*, kNumParameters> parameters {};
+    std::vector<int> indexForProcessorIndex;    // AudioProcessor parameter index -> ours
+
+    std::array<std::atomic<bool>, kNumParameters> dirty;
+    std::atomic<bool> anyDirty { false };
+
+    std::array<bool, kNumParameters> uiGesture {};
+    bool layoutPending = true;
+    std::vector<float> packed;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ParameterStream)
+};
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <utility>
+
+// Allpass cascade for the phaser with the stage count fixed at compile time.
+//
+// One instantiation exists per supported stage count; the processor picks one
+// per block through getProcessFunction(). L and R share a SIMD register (lanes
+// 0 and 1), and the stage loop is unrolled so state and coefficients stay in
+// registers for the whole control interval. SampleType is the audio precision
+// (a double register still holds L/R); coefficients arrive as float ramps.
+template <typename SampleType>
+class PhaserCascade
+{
+public:
+    using Vec = juce::dsp::SIMDRegister<SampleType>;
+
+    static constexpr int kMinStages = 2;
+    static constexpr int kMaxStages = 12;
+
+    // One control interval of input, with coefficient ramps for each channel
+    struct Block
+    {
+        const SampleType* inputL;
+        const SampleType* inputR;
+        SampleType* wetL;
+        SampleType* wetR;
+        int numSamples;
+
+        const float* coeffL;       // start values, one per stage
+        const float* coeffR;
+        const float* coeffIncL;    // per-sample increments
+        const float* coeffIncR;
+
+        float feedback;            // smoothed feedback amount before the first sample
+        float feedbackInc;
+        SampleType* feedbackSample; // last wet L/R, read and updated
+    };
+
+    using ProcessFunction = void (PhaserCascade::*)(const Block&);
+
+    static ProcessFunction getProcessFunction(int numStages);
+
+    void reset()
+    {
+        for (auto& s : state)
+            s = Vec::expand(SampleType(0));
+    }
+
+    template <int NumStages>
+    void process(const Block& block)
+    {
+        static_assert(NumStages >= kMinStages && NumStages <= kMaxStages, "unsupported stage count");
+
+        Vec z[NumStages], c[NumStages], dc[NumStages];
+        for (int s = 0; s < NumStages; ++s)
+        {
+            z[s] = state[static_cast<size_t>(s)];
+            c[s] = pair(block.coeffL[s], block.coeffR[s]);
+            dc[s] = pair(block.coeffIncL[s], block.coeffIncR[s]);
+        }
+
+        Vec fb = pair(block.feedbackSample[0], block.feedbackSample[1]);
+        float feedback = block.feedback;
+
+        for (int i = 0; i < block.numSamples; ++i)
+        {
+            feedback += block.feedbackInc;
+
+            const Vec x = pair(block.inputL[i], block.inputR[i]) + fb * static_cast<SampleType>(feedback * 0.7f);
+            fb = runStages(x, z, c, dc, std::make_integer_sequence<int, NumStages>());
+
+            block.wetL[i] = fb.get(0);
+            block.wetR[i] = fb.get(1);
+        }
+
+        for (int s = 0; s < NumStages; ++s)
+            state[static_cast<size_t>(s)] = z[s];
+
+        block.feedbackSample[0] = fb.get(0);
+        block.feedbackSample[1] = fb.get(1);
+    }
+
+private:
+    static Vec pair(SampleType left, SampleType right)
+    {
+        alignas(Vec::SIMDRegisterSize) SampleType lanes[Vec::size()] {};
+        lanes[0] = left;
+        lanes[1] = right;
+        return Vec::fromRawArray(lanes);
+    }
+
+    static void tick(Vec& x, Vec& z, Vec& c, const Vec& dc)
+    {
+        const Vec y = z - x * c;
+        z = y * c + x;
+        c += dc;
+        x = y;
+    }
+
+    template <int... S>
+    static Vec runStages(Vec x, Vec* z, Vec* c, const Vec* dc, std::integer_sequence<int, S...>)
+    {
+        (tick(x, z[S], c[S], dc[S]), ...);
+        return x;
+    }
+
+    template <int... N>
+    static constexpr std::array<ProcessFunction, sizeof...(N)> makeTable(std::integer_sequence<int, N...>)
+    {
+        return { { &PhaserCascade::process<N + kMinStages>... } };
+    }
+
+    std::array<Vec, kMaxStages> state;
+};
+
+template <typename SampleType>
+typename PhaserCascade<SampleType>::ProcessFunction PhaserCascade<SampleType>::getProcessFunction(int numStages)
+{
+    static constexpr auto table = makeTable(std::make_integer_sequence<int, kMaxStages - kMinStages + 1>());
+    return table[static_cast<size_t>(juce::jlimit(kMinStages, kMaxStages, numStages) - kMinStages)];
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+
+// Allpass coefficients for the phaser, without std::tan or std::sin.
+//
+// The first-order allpass coefficient (tan(pi f / fs) - 1) / (tan(pi f / fs) + 1)
+// is tabulated over 0..kMaxFreq for the current sample rate and read with
+// linear interpolation (error < 1e-6 at 44.1 kHz and above; sway_bench
+// --verify measures it). The per-stage sine weights
+// only depend on the stage count and are rebuilt when it changes.
+class PhaserCoefficientGenerator
+{
+public:
+    static constexpr int kMaxStages = 12;
+    static constexpr float kMaxFreq = 8000.0f;  // top of the Color range
+    static constexpr int kTableSize = 512;
+
+    void prepare(double sampleRate)
+    {
+        // Keep the table below Nyquist at very low sample rates
+        const double nyquistGuard = 0.49 * sampleRate;
+
+        for (int i = 0; i <= kTableSize; ++i)
+        {
+            const double freq = juce::jmin(nyquistGuard, static_cast<double>(kMaxFreq) * i / kTableSize);
+            const double t = std::tan(juce::MathConstants<double>::pi * freq / sampleRate);
+            table[static_cast<size_t>(i)] = static_cast<float>((t - 1.0) / (t + 1.0));
+        }
+        // Guard point so a read at exactly kMaxFreq can touch index + 1
+        table[kTableSize + 1] = table[kTableSize];
+
+        numStages = 0;
+    }
+
+    void setNumStages(int newNumStages)
+    {
+        newNumStages = juce::jlimit(1, kMaxStages, newNumStages);
+        if (newNumStages == numStages)
+            return;
+
+        numStages = newNumStages;
+
+        // Each stage modulated with phase offset
+        for (int s = 0; s < kMaxStages; ++s)
+        {
+            const float stagePhase = static_cast<float>(s) / static_cast<float>(numStages);
+            stageWeights[static_cast<size_t>(s)] = s < numStages
+                ? std::sin(stagePhase * juce::MathConstants<float>::pi)
+                : 0.0f;
+        }
+    }
+
+    int getNumStages() const { return numStages; }
+
+    float getCoefficient(float freq) const
+    {
+        const float pos = juce::jlimit(0.0f, static_cast<float>(kTableSize), freq * kIndexScale);
+        const int idx = static_cast<int>(pos);
+        const float frac = pos - static_cast<float>(idx);
+        return table[static_cast<size_t>(idx)] + (table[static_cast<size_t>(idx) + 1] - table[static_cast<size_t>(idx)]) * frac;
+    }
+
+    // Writes getNumStages() coefficients for one channel's LFO value
+    void computeCoefficients(float lfo, float depth, float minFreq, float maxFreq, float* coefficients) const
+    {
+        const float centre = minFreq + (maxFreq - minFreq) * 0.5f;
+        const float swing = (maxFreq - minFreq) * lfo * depth * 0.5f;
+
+        for (int s = 0; s < numStages; ++s)
+            coefficients[s] = getCoefficient(centre + swing * stageWeights[static_cast<size_t>(s)]);
+    }
+
+private:
+    static constexpr float kIndexScale = static_cast<float>(kTableSize) / kMaxFreq;
+
+    std::array<float, kTableSize + 2> table {};
+    std::array<float, kMaxStages> stageWeights {};
+    int numStages = 0;
+};
@@ -2,115 +2,108 @@
 #include "PluginEditor.h"
 #include "ParameterIDs.h"
 
-#if HAS_WEB_UI_DATA
-#include "WebUIData.h"
-#endif
-
 SwayAudioProcessorEditor::SwayAudioProcessorEditor(SwayAudioProcessor& p)
     : AudioProcessorEditor(&p), processorRef(p)
 {
+    openStartMs = juce::Time::getMillisecondCounterHiRes();
+
     setSize(850, 550);
     setResizable(false, false);
 
-    // Create relays
-    modeRelay = std::make_unique<juce::WebSliderRelay>(ParameterIDs::mode);
-    rateRelay = std::make_unique<juce::WebSliderRelay>(ParameterIDs::rate);
-    depthRelay = std::make_unique<juce::WebSliderRelay>(ParameterIDs::depth);
-    shapeRelay = std::make_unique<juce::WebSliderRelay>(ParameterIDs::shape);
-    stereoPhaseRelay = std::make_unique<juce::WebSliderRelay>(ParameterIDs::stereoPhase);
-    feedbackRelay = std::make_unique<juce::WebSliderRelay>(ParameterIDs::feedback);
-    voicesRelay = std::make_unique<juce::WebSliderRelay>(ParameterIDs::voices);
-    spreadRelay = std::make_unique<juce::WebSliderRelay>(ParameterIDs::spread);
-    warmthRelay = std::make_unique<juce::WebSliderRelay>(ParameterIDs::warmth);
-    stagesRelay = std::make_unique<juce::WebSliderRelay>(ParameterIDs::stages);
-    colorRelay = std::make_unique<juce::WebSliderRelay>(ParameterIDs::color);
-    mixRelay = std::make_unique<juce::WebSliderRelay>(ParameterIDs::mix);
-    widthRelay = std::make_unique<juce::WebSliderRelay>(ParameterIDs::width);
-    bypassRelay = std::make_unique<juce::WebToggleButtonRelay>(ParameterIDs::bypass);
-
     setupWebView();
 
-    // Create attachments
-    auto& apvts = processorRef.getAPVTS();
-    modeAttachment = std::make_unique<juce::WebSliderParameterAttachment>(*apvts.getParameter(ParameterIDs::mode), *modeRelay, nullptr);
-    rateAttachment = std::make_unique<juce::WebSliderParameterAttachment>(*apvts.getParameter(ParameterIDs::rate), *rateRelay, nullptr);
-    depthAttachment = std::make_unique<juce::WebSliderParameterAttachment>(*apvts.getParameter(ParameterIDs::depth), *depthRelay, nullptr);
-    shapeAttachment = std::make_unique<juce::WebSliderParameterAttachment>(*apvts.getParameter(ParameterIDs::shape), *shapeRelay, nullptr);
-    stereoPhaseAttachment = std::make_unique<juce::WebSliderParameterAttachment>(*apvts.getParameter(ParameterIDs::stereoPhase), *stereoPhaseRelay, nullptr);
-    feedbackAttachment = std::make_unique<juce::WebSliderParameterAttachment>(*apvts.getParameter(ParameterIDs::feedback), *feedbackRelay, nullptr);
-    voicesAttachment = std::make_unique<juce::WebSliderParameterAttachment>(*apvts.getParameter(ParameterIDs::voices), *voicesRelay, nullptr);
-    spreadAttachment = std::make_unique<juce::WebSliderParameterAttachment>(*apvts.getParameter(ParameterIDs::spread), *spreadRelay, nullptr);
-    warmthAttachment = std::make_unique<juce::WebSliderParameterAttachment>(*apvts.getParameter(ParameterIDs::warmth), *warmthRelay, nullptr);
-    stagesAttachment = std::make_unique<juce::WebSliderParameterAttachment>(*apvts.getParameter(ParameterIDs::stages), *stagesRelay, nullptr);
-    colorAttachment = std::make_unique<juce::WebSliderParameterAttachment>(*apvts.getParameter(ParameterIDs::color), *colorRelay, nullptr);
-    mixAttachment = std::make_unique<juce::WebSliderParameterAttachment>(*apvts.getParameter(ParameterIDs::mix), *mixRelay, nullptr);
-    widthAttachment = std::make_unique<juce::WebSliderParameterAttachment>(*apvts.getParameter(ParameterIDs::width), *widthRelay, nullptr);
-    bypassAttachment = std::make_unique<juce::WebToggleButtonParameterAttachment>(*apvts.getParameter(ParameterIDs::bypass), *bypassRelay, nullptr);
-
-    visualizerTimer.startTimerHz(60);
+    // Snapshots queued while no editor was open are stale
+    processorRef.getVisualizerFifo().discardPending();
+    visualizerTimer.startTimerHz(VisualizerTransport::kActiveRateHz);
 }
 
 SwayAudioProcessorEditor::~SwayAudioProcessorEditor()
 {
     visualizerTimer.stopTimer();
+
+    if (webView != nullptr)
+        removeChildComponent(webView);
+
+    webViewPool.release(std::move(webSession));
 }
 
 void SwayAudioProcessorEditor::setupWebView()
 {
-    auto options = juce::WebBrowserComponent::Options{}
-        .withBackend(juce::WebBrowserComponent::Options::Backend::webview2)
-        .withWinWebView2Options(
-            juce::WebBrowserComponent::Options::WinWebView2{}
-                .withUserDataFolder(juce::File::getSpecialLocation(juce::File::tempDirectory).getChildFile("Sway"))
-        )
-        .withOptionsFrom(*modeRelay)
-        .withOptionsFrom(*rateRelay)
-        .withOptionsFrom(*depthRelay)
-        .withOptionsFrom(*shapeRelay)
-        .withOptionsFrom(*stereoPhaseRelay)
-        .withOptionsFrom(*feedbackRelay)
-        .withOptionsFrom(*voicesRelay)
-        .withOptionsFrom(*spreadRelay)
-        .withOptionsFrom(*warmthRelay)
-        .withOptionsFrom(*stagesRelay)
-        .withOptionsFrom(*colorRelay)
-        .withOptionsFrom(*mixRelay)
-        .withOptionsFrom(*widthRelay)
-        .withOptionsFrom(*bypassRelay)
-        .withNativeIntegrationEnabled()
-#if BEATCONNECT_ACTIVATION_ENABLED
-        .withEventListener("activateLicense", [this](const juce::var& data) { handleActivateLicense(data); })
-        .withEventListener("deactivateLicense", [this](const juce::var& data) { handleDeactivateLicense(data); })
-        .withEventListener("getActivationStatus", [this](const juce::var&) { handleGetActivationStatus(); })
-#endif
-        .withEventListener("getPluginInfo", [this](const juce::var&) {
-            juce::DynamicObject::Ptr info = new juce::DynamicObject();
-            info->setProperty("hasActivation", processorRef.hasActivationEnabled());
-            webView->emitEventIfBrowserIsVisible("pluginInfo", juce::var(info.get()));
-        });
-
-    webView = std::make_unique<juce::WebBrowserComponent>(options);
+    webSession = webViewPool.acquire();
+    webView = &webSession->getBrowser();
     addAndMakeVisible(*webView);
 
-#if SWAY_DEV_MODE
-    webView->goToURL("http://localhost:5173");
-#elif HAS_WEB_UI_DATA
-    webView->goToURL(juce::WebBrowserComponent::getResourceProviderRoot());
+    webSession->setEventHandler([this](const juce::Identifier& eventId, const juce::var& data)
+    {
+        handleWebEvent(eventId, data);
+    });
+
+    // Immediate for a reused session, otherwise once the page has loaded
+    const bool warm = webSession->isUiReady();
+    webSession->onUiReady([this, warm]
+    {
+        webViewPool.recordOpenLatency(juce::Time::getMillisecondCounterHiRes() - openStartMs, warm);
+    });
+}
+
+void SwayAudioProcessorEditor::handleWebEvent(const juce::Identifier& eventId, const juce::var& data)
+{
+#if BEATCONNECT_ACTIVATION_ENABLED
+    if (eventId == juce::Identifier("activateLicense"))          { handleActivateLicense(data); return; }
+    if (eventId == juce::Identifier("deactivateLicense"))        { handleDeactivateLicense(data); return; }
+    if (eventId == juce::Identifier("getActivationStatus"))      { handleGetActivationStatus(); return; }
 #endif
+
+    if (eventId == juce::Identifier("parameterChange"))      { parameterStream.handleChange(data); return; }
+    if (eventId == juce::Identifier("parameterGesture"))     { parameterStream.handleGesture(data); return; }
+    if (eventId == juce::Identifier("requestParameters"))    { parameterStream.resendAll(); return; }
+
+    if (eventId == juce::Identifier("getPluginInfo"))
+    {
+        const auto latency = webViewPool.getOpenLatency();
+
+        juce::DynamicObject::Ptr info = new juce::DynamicObject();
+        info->setProperty("hasActivation", processorRef.hasActivationEnabled());
+        info->setProperty("editorOpenMs", latency.lastMs);
+        info->setProperty("editorOpenMeanMs", latency.meanMs);
+        info->setProperty("editorOpenWarm", latency.lastWasWarm);
+        webView->emitEventIfBrowserIsVisible("pluginInfo", juce::var(info.get()));
+    }
 }
 
 void SwayAudioProcessorEditor::VisualizerTimer::timerCallback()
 {
     if (editor.webView == nullptr) return;
 
-    juce::DynamicObject::Ptr data = new juce::DynamicObject();
-    data->setProperty("rms", editor.processorRef.getCurrentRMS());
-    data->setProperty("lfoPhase", editor.processorRef.getLfoPhase());
-    data->setProperty("modulation", editor.processorRef.getModulationAmount());
-    data->setProperty("mode", editor.processorRef.getCurrentMode());
-    data->setProperty("bypassed", editor.processorRef.isBypassed());
-
-    editor.webView->emitEventIfBrowserIsVisible("visualizerData", juce::var(data.get()));
+    // isShowing() is false while hidden or minimised; keep draining so the queue stays fresh
+    const bool visible = editor.isShowing();
+    auto& transport = editor.visualizerTransport;
+
+    VisualizerSnapshot snapshot;
+    while (editor.processorRef.getVisualizerFifo().pop(snapshot))
+        if (visible)
+            transport.add(snapshot);
+
+    const bool sending = transport.hasPendingFrames();
+    if (sending)
+        editor.webView->emitEventIfBrowserIsVisible("visualizerFrames", transport.takePayload());
+
+    // Every parameter that changed since the last tick goes out as one message
+    auto& parameters = editor.parameterStream;
+    if (parameters.isLayoutPending())
+        editor.webView->emitEventIfBrowserIsVisible("parameterLayout", parameters.takeLayout());
+
+    const bool parametersChanged = parameters.hasPendingChanges();
+    if (parametersChanged)
+    {
+        const auto payload = parameters.takePayload();
+        if (payload.isNotEmpty())
+            editor.webView->emitEventIfBrowserIsVisible("parameterFrames", payload);
+    }
+
+    const int rateHz = transport.getNextRateHz(visible, sending || parametersChanged);
+    if (getTimerInterval() != 1000 / rateHz)
+        startTimerHz(rateHz);
 }
 
 #if BEATCONNECT_ACTIVATION_ENABLED
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "PluginProcessor.h"
+#include "VisualizerTransport.h"
+#include "ParameterStream.h"
+#include "SharedWebView.h"
 #include <juce_gui_extra/juce_gui_extra.h>
 
 class SwayAudioProcessorEditor : public juce::AudioProcessorEditor
@@ -14,6 +17,7 @@ public:
 
 private:
     void setupWebView();
+    void handleWebEvent(const juce::Identifier& eventId, const juce::var& data);
 
 #if BEATCONNECT_ACTIVATION_ENABLED
     void sendActivationState();
@@ -24,39 +28,16 @@ private:
 
     SwayAudioProcessor& processorRef;
 
-    // Relays
-    std::unique_ptr<juce::WebSliderRelay> modeRelay;
-    std::unique_ptr<juce::WebSliderRelay> rateRelay;
-    std::unique_ptr<juce::WebSliderRelay> depthRelay;
-    std::unique_ptr<juce::WebSliderRelay> shapeRelay;
-    std::unique_ptr<juce::WebSliderRelay> stereoPhaseRelay;
-    std::unique_ptr<juce::WebSliderRelay> feedbackRelay;
-    std::unique_ptr<juce::WebSliderRelay> voicesRelay;
-    std::unique_ptr<juce::WebSliderRelay> spreadRelay;
-    std::unique_ptr<juce::WebSliderRelay> warmthRelay;
-    std::unique_ptr<juce::WebSliderRelay> stagesRelay;
-    std::unique_ptr<juce::WebSliderRelay> colorRelay;
-    std::unique_ptr<juce::WebSliderRelay> mixRelay;
-    std::unique_ptr<juce::WebSliderRelay> widthRelay;
-    std::unique_ptr<juce::WebToggleButtonRelay> bypassRelay;
+    // The browser comes from the shared pool, which the first editor creates;
+    // parameters reach it through the stream
+    WebViewPool& webViewPool { *WebViewPool::getInstance() };
+    std::unique_ptr<WebViewSession> webSession;
+    juce::WebBrowserComponent* webView = nullptr;
+    double openStartMs = 0.0;
 
-    // Attachments
-    std::unique_ptr<juce::WebSliderParameterAttachment> modeAttachment;
-    std::unique_ptr<juce::WebSliderParameterAttachment> rateAttachment;
-    std::unique_ptr<juce::WebSliderParameterAttachment> depthAttachment;
-    std::unique_ptr<juce::WebSliderParameterAttachment> shapeAttachment;
-    std::unique_ptr<juce::WebSliderParameterAttachment> stereoPhaseAttachment;
-    std::unique_ptr<juce::WebSliderParameterAttachment> feedbackAttachment;
-    std::unique_ptr<juce::WebSliderParameterAttachment> voicesAttachment;
-    std::unique_ptr<juce::WebSliderParameterAttachment> spreadAttachment;
-    std::unique_ptr<juce::WebSliderParameterAttachment> warmthAttachment;
-    std::unique_ptr<juce::WebSliderParameterAttachment> stagesAttachment;
-    std::unique_ptr<juce::WebSliderParameterAttachment> colorAttachment;
-    std::unique_ptr<juce::WebSliderParameterAttachment> mixAttachment;
-    std::unique_ptr<juce::WebSliderParameterAttachment> widthAttachment;
-    std::unique_ptr<juce::WebToggleButtonParameterAttachment> bypassAttachment;
+    ParameterStream parameterStream { processorRef.getAPVTS() };
 
-    std::unique_ptr<juce::WebBrowserComponent> webView;
+    VisualizerTransport visualizerTransport;
 
     class VisualizerTimer : public juce::Timer
     {
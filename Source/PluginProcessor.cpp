@@ -6,21 +6,49 @@
 */
 
 #include "PluginProcessor.h"
-#include "PluginEditor.h"
 #include "ParameterIDs.h"
+#include "RealtimeSafety.h"
+
+#if ! SWAY_HEADLESS
+#include "PluginEditor.h"
+#endif
 
 SwayAudioProcessor::SwayAudioProcessor()
     : AudioProcessor(BusesProperties()
         .withInput("Input", juce::AudioChannelSet::stereo(), true)
         .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
-      apvts(*this, nullptr, "Parameters", createParameterLayout()),
-      rng(std::random_device{}())
+      apvts(*this, nullptr, "Parameters", createParameterLayout())
 {
+    rawParameters.mode = apvts.getRawParameterValue(ParameterIDs::mode);
+    rawParameters.rate = apvts.getRawParameterValue(ParameterIDs::rate);
+    rawParameters.depth = apvts.getRawParameterValue(ParameterIDs::depth);
+    rawParameters.shape = apvts.getRawParameterValue(ParameterIDs::shape);
+    rawParameters.stereoPhase = apvts.getRawParameterValue(ParameterIDs::stereoPhase);
+    rawParameters.feedback = apvts.getRawParameterValue(ParameterIDs::feedback);
+    rawParameters.voices = apvts.getRawParameterValue(ParameterIDs::voices);
+    rawParameters.spread = apvts.getRawParameterValue(ParameterIDs::spread);
+    rawParameters.warmth = apvts.getRawParameterValue(ParameterIDs::warmth);
+    rawParameters.warmthQuality = apvts.getRawParameterValue(ParameterIDs::warmthQuality);
+    rawParameters.interpolation = apvts.getRawParameterValue(ParameterIDs::interpolation);
+    rawParameters.stages = apvts.getRawParameterValue(ParameterIDs::stages);
+    rawParameters.color = apvts.getRawParameterValue(ParameterIDs::color);
+    rawParameters.mix = apvts.getRawParameterValue(ParameterIDs::mix);
+    rawParameters.width = apvts.getRawParameterValue(ParameterIDs::width);
+    rawParameters.bypass = apvts.getRawParameterValue(ParameterIDs::bypass);
+
+    for (const auto* id : ParameterIDs::all)
+        apvts.addParameterListener(id, this);
+
     loadProjectData();
+    startTimerHz(kLatencyPollRateHz);
 }
 
 SwayAudioProcessor::~SwayAudioProcessor()
 {
+    for (const auto* id : ParameterIDs::all)
+        apvts.removeParameterListener(id, this);
+
+    stopTimer();
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout SwayAudioProcessor::createParameterLayout()
@@ -87,6 +115,18 @@ juce::AudioProcessorValueTreeState::ParameterLayout SwayAudioProcessor::createPa
         warmthDefault, juce::AudioParameterFloatAttributes().withLabel("%")
     ));
 
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID { warmthQuality, 2 }, "Warmth Quality",
+        juce::StringArray { "Eco", "HQ 2x", "HQ 4x" },
+        warmthQualityDefault
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID { interpolation, 3 }, "Interpolation",
+        juce::StringArray { "Linear", "Cubic", "Allpass" },
+        interpolationDefault
+    ));
+
     // Phaser specific
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         juce::ParameterID { stages, 1 }, "Stages",
@@ -159,67 +199,184 @@ bool SwayAudioProcessor::hasActivationEnabled() const
 #endif
 }
 
-float SwayAudioProcessor::getSineLFO(float phase)
+void SwayAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
-    return std::sin(phase * juce::MathConstants<float>::twoPi);
-}
+    currentSampleRate = sampleRate;
 
-float SwayAudioProcessor::getTriangleLFO(float phase)
-{
-    return 4.0f * std::abs(phase - 0.5f) - 1.0f;
-}
+    const auto quality = static_cast<WarmthQuality>(static_cast<int>(rawParameters.warmthQuality->load()));
+    const auto seed = randomSeed.load();
+    routeChannels(getChannelLayoutOfBus(false, 0));
 
-float SwayAudioProcessor::getSquareLFO(float phase)
-{
-    return phase < 0.5f ? 1.0f : -1.0f;
+    int numWetPairs = 0;
+    for (int p = 0; p < numPairs; ++p)
+        numWetPairs += pairRouting[static_cast<size_t>(p)].dry ? 0 : 1;
+
+    for (int p = 0, wetIndex = 0; p < numPairs; ++p)
+    {
+        // Reset LFO. Wet pairs are spread evenly around the cycle, the front pair
+        // at 0, and draw from their own PCG streams of the same seed. Rotation is
+        // per pair rather than per channel, so partners keep the stereo phase
+        // setting between them.
+        auto& pairModulation = modulation[static_cast<size_t>(p)];
+        pairModulation.setPhaseOffset(static_cast<float>(wetIndex) / static_cast<float>(juce::jmax(1, numWetPairs)));
+        if (! pairRouting[static_cast<size_t>(p)].dry)
+            ++wetIndex;
+        pairModulation.setSeed(seed, p);
+        pairModulation.prepare(sampleRate, controlInterval);
+    }
+
+    // The host picks the precision before preparing; only that set of buffers is allocated
+    const int latency = isUsingDoublePrecision() ? prepareChannelPairs<double>(sampleRate, quality)
+                                                 : prepareChannelPairs<float>(sampleRate, quality);
+    reportedLatency.store(latency);
+    setLatencySamples(latency);
+
+    // Smoothing
+    rateSmoothed.reset(sampleRate, 0.05);
+    depthSmoothed.reset(sampleRate, 0.02);
+    feedbackSmoothed.reset(sampleRate, 0.02);
+    mixSmoothed.reset(sampleRate, 0.02);
+
+    rateSmoothed.setCurrentAndTargetValue(rawParameters.rate->load());
+    depthSmoothed.setCurrentAndTargetValue(rawParameters.depth->load() / 100.0f);
+    feedbackSmoothed.setCurrentAndTargetValue(rawParameters.feedback->load() / 100.0f);
+    mixSmoothed.setCurrentAndTargetValue(rawParameters.mix->load() / 100.0f);
+
+    samplesUntilSnapshot = 0;
+
+    samplesUntilIdle = static_cast<int>(std::ceil(kTailSeconds * sampleRate));
+    silentSamples = 0;
+    idle.store(false, std::memory_order_relaxed);
+
+    // Sample rate dependent; rebuilt on the first block
+    derivedValid = false;
 }
 
-float SwayAudioProcessor::getRandomLFO(float phase, int channel)
+void SwayAudioProcessor::routeChannels(const juce::AudioChannelSet& layout)
 {
-    // Smoothed random - new target each cycle
-    if (phase < lastRandomPhase)
+    using Type = juce::AudioChannelSet::ChannelType;
+
+    static constexpr std::pair<Type, Type> partners[] = {
+        { Type::left, Type::right },                         { Type::leftCentre, Type::rightCentre },
+        { Type::leftSurround, Type::rightSurround },         { Type::leftSurroundSide, Type::rightSurroundSide },
+        { Type::leftSurroundRear, Type::rightSurroundRear }, { Type::wideLeft, Type::wideRight },
+        { Type::topFrontLeft, Type::topFrontRight },         { Type::topSideLeft, Type::topSideRight },
+        { Type::topRearLeft, Type::topRearRight },           { Type::bottomFrontLeft, Type::bottomFrontRight },
+        { Type::bottomSideLeft, Type::bottomSideRight },     { Type::bottomRearLeft, Type::bottomRearRight }
+    };
+
+    static constexpr Type centres[] = { Type::centre, Type::centreSurround, Type::topMiddle, Type::topFrontCentre,
+                                        Type::topRearCentre, Type::bottomFrontCentre, Type::bottomRearCentre };
+
+    const auto types = layout.getChannelTypes();
+    const int numChannels = juce::jmin(types.size(), kMaxChannels);
+
+    std::array<bool, kMaxChannels> routed {};
+    std::array<int, kMaxChannels> unpaired {};
+    int numUnpaired = 0;
+    numPairs = 0;
+
+    for (int ch = 0; ch < numChannels; ++ch)
     {
-        randomLfoTarget[channel] = std::uniform_real_distribution<float>(-1.0f, 1.0f)(rng);
+        if (routed[static_cast<size_t>(ch)])
+            continue;
+
+        routed[static_cast<size_t>(ch)] = true;
+        const auto type = types[ch];
+
+        if (type == Type::LFE || type == Type::LFE2)
+        {
+            pairRouting[static_cast<size_t>(numPairs++)] = { ch, -1, true };
+            continue;
+        }
+
+        if (std::find(std::begin(centres), std::end(centres), type) != std::end(centres))
+        {
+            pairRouting[static_cast<size_t>(numPairs++)] = { ch, -1, false };
+            continue;
+        }
+
+        int partner = -1;
+        bool isLeft = true;
+        for (const auto& [leftType, rightType] : partners)
+        {
+            if (type == leftType || type == rightType)
+            {
+                partner = layout.getChannelIndexForType(type == leftType ? rightType : leftType);
+                isLeft = type == leftType;
+                break;
+            }
+        }
+
+        if (partner >= 0 && partner < numChannels && ! routed[static_cast<size_t>(partner)])
+        {
+            routed[static_cast<size_t>(partner)] = true;
+            pairRouting[static_cast<size_t>(numPairs++)] = isLeft ? PairRouting { ch, partner, false }
+                                                                  : PairRouting { partner, ch, false };
+            continue;
+        }
+
+        unpaired[static_cast<size_t>(numUnpaired++)] = ch;
     }
-    lastRandomPhase = phase;
 
-    // Smooth interpolation towards target
-    randomLfoValue[channel] += (randomLfoTarget[channel] - randomLfoValue[channel]) * 0.01f;
-    return randomLfoValue[channel];
+    for (int i = 0; i < numUnpaired; i += 2)
+        pairRouting[static_cast<size_t>(numPairs++)] = { unpaired[static_cast<size_t>(i)],
+                                                         i + 1 < numUnpaired ? unpaired[static_cast<size_t>(i + 1)] : -1,
+                                                         false };
+
+    // A disabled bus still gets one pair, which process() finds no channels for
+    if (numPairs == 0)
+        pairRouting[static_cast<size_t>(numPairs++)] = {};
 }
 
-void SwayAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
+template <typename SampleType>
+int SwayAudioProcessor::prepareChannelPairs(double sampleRate, WarmthQuality quality)
 {
-    currentSampleRate = sampleRate;
+    auto& pairs = getChannelPairs<SampleType>();
 
-    // Clear delay lines
-    for (auto& dl : delayLines)
-        dl.fill(0.0f);
-    writePos = 0;
+    for (int p = 0; p < numPairs; ++p)
+    {
+        auto& pair = pairs[static_cast<size_t>(p)];
 
-    // Reset phaser allpasses
-    for (auto& ch : phaserStages)
-        for (auto& stage : ch)
-            stage.z1 = 0.0f;
+        // Size the delay line for the longest delay at this sample rate
+        pair.delayLine.prepare(sampleRate, kMaxDelayMs);
 
-    // Reset LFO
-    lfoPhase[0] = lfoPhase[1] = 0.0f;
-    randomLfoValue[0] = randomLfoValue[1] = 0.0f;
-    randomLfoTarget[0] = randomLfoTarget[1] = 0.0f;
-    lastRandomPhase = 0.0f;
+        // Reset phaser allpasses
+        pair.phaserCascade.reset();
 
-    feedbackSample[0] = feedbackSample[1] = 0.0f;
+        pair.feedbackSample[0] = pair.feedbackSample[1] = SampleType(0);
 
-    // Smoothing
-    rateSmoothed.reset(sampleRate, 0.05);
-    depthSmoothed.reset(sampleRate, 0.02);
-    feedbackSmoothed.reset(sampleRate, 0.02);
-    mixSmoothed.reset(sampleRate, 0.02);
+        // Saturation runs on one control interval of wet signal at a time
+        pair.warmthSaturator.prepare(sampleRate, ModulationEngine::kMaxControlInterval);
+    }
+
+    return setWarmthQuality<SampleType>(quality);
+}
+
+template <typename SampleType>
+void SwayAudioProcessor::clearChannelPairs()
+{
+    auto& pairs = getChannelPairs<SampleType>();
 
-    rateSmoothed.setCurrentAndTargetValue(apvts.getRawParameterValue(ParameterIDs::rate)->load());
-    depthSmoothed.setCurrentAndTargetValue(apvts.getRawParameterValue(ParameterIDs::depth)->load() / 100.0f);
-    feedbackSmoothed.setCurrentAndTargetValue(apvts.getRawParameterValue(ParameterIDs::feedback)->load() / 100.0f);
-    mixSmoothed.setCurrentAndTargetValue(apvts.getRawParameterValue(ParameterIDs::mix)->load() / 100.0f);
+    for (int p = 0; p < numPairs; ++p)
+    {
+        auto& pair = pairs[static_cast<size_t>(p)];
+        pair.delayLine.clear();
+        pair.phaserCascade.reset();
+        pair.warmthSaturator.reset();
+        pair.feedbackSample[0] = pair.feedbackSample[1] = SampleType(0);
+    }
+}
+
+template <typename SampleType>
+int SwayAudioProcessor::setWarmthQuality(WarmthQuality quality)
+{
+    auto& pairs = getChannelPairs<SampleType>();
+
+    for (int p = 0; p < numPairs; ++p)
+        pairs[static_cast<size_t>(p)].warmthSaturator.setQuality(quality);
+
+    return pairs[0].warmthSaturator.getLatencySamples();
 }
 
 void SwayAudioProcessor::releaseResources()
@@ -228,56 +385,238 @@ void SwayAudioProcessor::releaseResources()
 
 bool SwayAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
 {
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-        && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // Any layout up to 7.1.4 (mono, stereo, 5.1, 7.1, ...), in place
+    const auto& output = layouts.getMainOutputChannelSet();
+    if (output.isDisabled() || output.size() > kMaxChannels)
         return false;
 
-    return layouts.getMainOutputChannelSet() == layouts.getMainInputChannelSet();
+    return output == layouts.getMainInputChannelSet();
 }
 
 void SwayAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
 {
+    process(buffer);
+}
+
+void SwayAudioProcessor::processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer&)
+{
+    process(buffer);
+}
+
+template <typename SampleType>
+void SwayAudioProcessor::process(juce::AudioBuffer<SampleType>& buffer)
+{
+    // Only the pairs of the precision set before prepareToPlay() are allocated
+    jassert(isUsingDoublePrecision() == (std::is_same_v<SampleType, double>));
+
+    // Allocation, locks and blocking calls from here on are reported in checked builds
+    const RealtimeSafety::ScopedRealtime realtime("processBlock");
+
     juce::ScopedNoDenormals noDenormals;
 
     const int numChannels = buffer.getNumChannels();
     const int numSamples = buffer.getNumSamples();
-    const float sampleRate = static_cast<float>(currentSampleRate);
 
     for (int i = getTotalNumInputChannels(); i < getTotalNumOutputChannels(); ++i)
         buffer.clear(i, 0, numSamples);
 
-    // Get parameters
-    const int modeVal = static_cast<int>(apvts.getRawParameterValue(ParameterIDs::mode)->load());
-    const float rateVal = apvts.getRawParameterValue(ParameterIDs::rate)->load();
-    const float depthVal = apvts.getRawParameterValue(ParameterIDs::depth)->load() / 100.0f;
-    const int shapeVal = static_cast<int>(apvts.getRawParameterValue(ParameterIDs::shape)->load());
-    const float stereoPhaseVal = apvts.getRawParameterValue(ParameterIDs::stereoPhase)->load() / 100.0f * 0.5f;
-    const float feedbackVal = apvts.getRawParameterValue(ParameterIDs::feedback)->load() / 100.0f;
-    const int voicesVal = static_cast<int>(apvts.getRawParameterValue(ParameterIDs::voices)->load());
-    const float spreadVal = apvts.getRawParameterValue(ParameterIDs::spread)->load() / 100.0f;
-    const float warmthVal = apvts.getRawParameterValue(ParameterIDs::warmth)->load() / 100.0f;
-    const int stagesVal = static_cast<int>(apvts.getRawParameterValue(ParameterIDs::stages)->load());
-    const float colorVal = apvts.getRawParameterValue(ParameterIDs::color)->load() / 100.0f;
-    const float mixVal = apvts.getRawParameterValue(ParameterIDs::mix)->load() / 100.0f;
-    const float widthVal = apvts.getRawParameterValue(ParameterIDs::width)->load() / 100.0f;
-    const bool bypassVal = apvts.getRawParameterValue(ParameterIDs::bypass)->load() > 0.5f;
-
-    currentMode.store(modeVal);
-    bypassed.store(bypassVal);
-
-    // Update smoothed values
-    rateSmoothed.setTargetValue(rateVal);
+    // Smoothed parameters are retargeted every block; everything else is
+    // derived only when a parameter has changed
+    const float depthVal = rawParameters.depth->load() / 100.0f;
+    rateSmoothed.setTargetValue(rawParameters.rate->load());
     depthSmoothed.setTargetValue(depthVal);
-    feedbackSmoothed.setTargetValue(feedbackVal);
-    mixSmoothed.setTargetValue(mixVal);
+    feedbackSmoothed.setTargetValue(rawParameters.feedback->load() / 100.0f);
+    mixSmoothed.setTargetValue(rawParameters.mix->load() / 100.0f);
 
-    // Visualizer data
+    // Read the version before the values, so a change racing with this block
+    // is picked up again on the next one
+    const auto version = parameterVersion.load(std::memory_order_acquire);
+    if (! derivedValid || version != derivedVersion)
+    {
+        updateDerivedState();
+        derivedVersion = version;
+        derivedValid = true;
+    }
+
+    // Visualizer data, measured on the input only for blocks that send a snapshot
+    const bool snapshotDue = isVisualizerSnapshotDue(numSamples);
     float inputRms = 0.0f;
+    if (snapshotDue)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+            inputRms += static_cast<float>(buffer.getRMSLevel(ch, 0, numSamples));
+        inputRms /= static_cast<float>(numChannels);
+    }
+
+    auto& pairs = getChannelPairs<SampleType>();
+
+    // A pair's channels may be missing from a buffer narrower than the bus
+    auto getChannel = [&buffer, numChannels](int channel) -> SampleType*
+    {
+        return channel >= 0 && channel < numChannels ? buffer.getWritePointer(channel) : nullptr;
+    };
+
+    if (derived.bypassed)
+    {
+        // Keep the dry signal aligned with the reported latency
+        for (int p = 0; p < numPairs; ++p)
+        {
+            const auto& route = pairRouting[static_cast<size_t>(p)];
+            if (auto* left = getChannel(route.left))
+                pairs[static_cast<size_t>(p)].warmthSaturator.delayDry(left, getChannel(route.right), numSamples);
+        }
+
+        if (snapshotDue)
+            pushVisualizerSnapshot(inputRms, derived.mode, derived.shape, true, depthVal,
+                                   derived.params.numVoices, derived.spread);
+        return;
+    }
+
+    SampleType inputPeak = 0;
     for (int ch = 0; ch < numChannels; ++ch)
-        inputRms += buffer.getRMSLevel(ch, 0, numSamples);
-    currentRMS.store(inputRms / static_cast<float>(numChannels));
+        inputPeak = juce::jmax(inputPeak, buffer.getMagnitude(ch, 0, numSamples));
+
+    const bool inputSilent = inputPeak <= kSilenceThreshold;
+
+    if (idle.load(std::memory_order_relaxed))
+    {
+        if (inputSilent)
+        {
+            // Nothing left in the wet path and nothing coming in: the block is
+            // passed through as is. Smoothers still move so a parameter changed
+            // meanwhile does not ramp on wake-up, and the LFOs keep time so the
+            // modulation after a silence is where it would have been anyway.
+            rateSmoothed.skip(numSamples);
+            depthSmoothed.skip(numSamples);
+            feedbackSmoothed.skip(numSamples);
+            mixSmoothed.skip(numSamples);
+
+            for (int p = 0; p < numPairs; ++p)
+                modulation[static_cast<size_t>(p)].skip(derived.params.modSettings, rateSmoothed.getCurrentValue(),
+                                                        derived.shape, numSamples);
+
+            if (snapshotDue)
+                pushVisualizerSnapshot(inputRms, derived.mode, derived.shape, false, depthVal,
+                                       derived.params.numVoices, derived.spread);
+            return;
+        }
+
+        // The state was cleared on the way in, so the wet path fades in from silence
+        idle.store(false, std::memory_order_relaxed);
+        silentSamples = 0;
+    }
+
+    // Every pair starts from the same smoother state; the last leaves them advanced by the block
+    const auto rateStart = rateSmoothed;
+    const auto depthStart = depthSmoothed;
+    const auto feedbackStart = feedbackSmoothed;
+    const auto mixStart = mixSmoothed;
 
-    if (bypassVal) return;
+    for (int p = 0; p < numPairs; ++p)
+    {
+        const auto& route = pairRouting[static_cast<size_t>(p)];
+        SampleType* left = getChannel(route.left);
+        SampleType* right = getChannel(route.right);
+
+        if (left == nullptr)
+            continue;
+
+        // LFE only follows the latency
+        if (route.dry)
+        {
+            pairs[static_cast<size_t>(p)].warmthSaturator.delayDry(left, nullptr, numSamples);
+            continue;
+        }
+
+        rateSmoothed = rateStart;
+        depthSmoothed = depthStart;
+        feedbackSmoothed = feedbackStart;
+        mixSmoothed = mixStart;
+
+        const auto& kernels = [this]() -> const KernelChoice<SampleType>&
+        {
+            if constexpr (std::is_same_v<SampleType, double>)
+                return derived.doubleKernels;
+            else
+                return derived.floatKernels;
+        }();
+
+        (this->*(right != nullptr ? kernels.stereo : kernels.mono))(p, left, right, numSamples, derived.params);
+    }
+
+    // The output is only scanned while the input is silent, i.e. while a tail may be dying away
+    if (inputSilent)
+    {
+        SampleType tailPeak = 0;
+        for (int ch = 0; ch < numChannels; ++ch)
+            tailPeak = juce::jmax(tailPeak, buffer.getMagnitude(ch, 0, numSamples));
+
+        // Also catches feedback that mix currently hides
+        for (int p = 0; p < numPairs; ++p)
+            for (const auto sample : pairs[static_cast<size_t>(p)].feedbackSample)
+                tailPeak = juce::jmax(tailPeak, std::abs(sample));
+
+        silentSamples = tailPeak <= kSilenceThreshold ? silentSamples + numSamples : 0;
+
+        if (silentSamples >= samplesUntilIdle)
+        {
+            // Whatever is left in the delay lines and allpasses is below the threshold
+            clearChannelPairs<SampleType>();
+            idle.store(true, std::memory_order_relaxed);
+        }
+    }
+    else
+    {
+        silentSamples = 0;
+    }
+
+    if (snapshotDue)
+        pushVisualizerSnapshot(inputRms, derived.mode, derived.shape, false, depthVal,
+                               derived.params.numVoices, derived.spread);
+}
+
+void SwayAudioProcessor::updateDerivedState()
+{
+    const int modeVal = static_cast<int>(rawParameters.mode->load());
+    const int shapeVal = static_cast<int>(rawParameters.shape->load());
+    const float stereoPhaseVal = rawParameters.stereoPhase->load() / 100.0f * 0.5f;
+    const int voicesVal = static_cast<int>(rawParameters.voices->load());
+    const float spreadVal = rawParameters.spread->load() / 100.0f;
+    const float warmthVal = rawParameters.warmth->load() / 100.0f;
+    const int warmthQualityVal = static_cast<int>(rawParameters.warmthQuality->load());
+    const int interpolationVal = static_cast<int>(rawParameters.interpolation->load());
+    const int stagesVal = static_cast<int>(rawParameters.stages->load());
+    const float colorVal = rawParameters.color->load() / 100.0f;
+    const float widthVal = rawParameters.width->load() / 100.0f;
+
+    derived.mode = modeVal;
+    derived.shape = shapeVal;
+    derived.spread = spreadVal;
+    derived.bypassed = rawParameters.bypass->load() > 0.5f;
+
+    // The allpass tier is for the flanger, whose short sweep is where linear
+    // taps dull the comb most; chorus and ensemble use cubic in its place.
+    // It is recursive, so entering it starts every tap from rest.
+    auto interpolation = static_cast<DelayInterpolation>(juce::jlimit(0, 2, interpolationVal));
+    if (interpolation == DelayInterpolation::allpass && modeVal != 1)
+        interpolation = DelayInterpolation::cubic;
+    if (interpolation == DelayInterpolation::allpass && derived.interpolation != interpolation)
+    {
+        for (int p = 0; p < numPairs; ++p)
+        {
+            if (isUsingDoublePrecision())
+                doublePairs[static_cast<size_t>(p)].delayLine.clearAllpasses();
+            else
+                floatPairs[static_cast<size_t>(p)].delayLine.clearAllpasses();
+        }
+    }
+    derived.interpolation = interpolation;
+
+    // A quality change moves the latency; the host is told from the message thread
+    const auto quality = static_cast<WarmthQuality>(juce::jlimit(0, 2, warmthQualityVal));
+    const int latency = isUsingDoublePrecision() ? setWarmthQuality<double>(quality)
+                                                 : setWarmthQuality<float>(quality);
+    reportedLatency.store(latency);
 
     // Mode-specific delay ranges
     float minDelay, maxDelay;
@@ -299,161 +638,281 @@ void SwayAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::Mi
             maxDelay = 10.0f;
     }
 
-    const float* inputL = buffer.getReadPointer(0);
-    const float* inputR = numChannels > 1 ? buffer.getReadPointer(1) : inputL;
-    float* outputL = buffer.getWritePointer(0);
-    float* outputR = numChannels > 1 ? buffer.getWritePointer(1) : outputL;
-
-    for (int i = 0; i < numSamples; ++i)
+    auto& params = derived.params;
+    params.modSettings.stereoPhase = stereoPhaseVal;
+    params.modSettings.numVoices = voicesVal;
+    params.modSettings.spread = spreadVal;
+    params.modSettings.minDelayMs = minDelay;
+    params.modSettings.maxDelayMs = maxDelay;
+    params.modSettings.numStages = stagesVal;
+    params.modSettings.minFreq = 200.0f;
+    params.modSettings.maxFreq = 4000.0f + colorVal * 4000.0f;
+    modulation[0].prepareSettings(params.modSettings);
+    params.processPhaser = PhaserCascade<float>::getProcessFunction(stagesVal);
+    params.processPhaserDouble = PhaserCascade<double>::getProcessFunction(stagesVal);
+    params.numVoices = voicesVal;
+    params.drive = 1.0f + warmthVal * 3.0f;
+    // Eco leaves the path while warmth is off; coming back, it must not resume from old samples
+    const bool warmthActive = warmthVal > 0.01f;
+    if (warmthActive && ! params.warmthActive)
     {
-        const float curRate = rateSmoothed.getNextValue();
-        const float curDepth = depthSmoothed.getNextValue();
-        const float curFeedback = feedbackSmoothed.getNextValue();
-        const float curMix = mixSmoothed.getNextValue();
-
-        // LFO rate: 0.01 to 20 Hz (exponential mapping)
-        const float lfoFreq = 0.01f * std::pow(2000.0f, curRate / 100.0f);
-        const float lfoInc = lfoFreq / sampleRate;
-
-        // Get LFO values for both channels
-        float lfoL, lfoR;
-        switch (shapeVal) {
-            case 0: lfoL = getSineLFO(lfoPhase[0]); lfoR = getSineLFO(lfoPhase[1]); break;
-            case 1: lfoL = getTriangleLFO(lfoPhase[0]); lfoR = getTriangleLFO(lfoPhase[1]); break;
-            case 2: lfoL = getSquareLFO(lfoPhase[0]); lfoR = getSquareLFO(lfoPhase[1]); break;
-            case 3: lfoL = getRandomLFO(lfoPhase[0], 0); lfoR = getRandomLFO(lfoPhase[1], 1); break;
-            default: lfoL = lfoR = getSineLFO(lfoPhase[0]);
+        for (int p = 0; p < numPairs; ++p)
+        {
+            if (isUsingDoublePrecision())
+                doublePairs[static_cast<size_t>(p)].warmthSaturator.forgetHistory();
+            else
+                floatPairs[static_cast<size_t>(p)].warmthSaturator.forgetHistory();
         }
+    }
+    params.warmthActive = warmthActive;
+    params.width = std::abs(widthVal - 1.0f) > 0.01f ? widthVal : 1.0f;
+
+    for (int v = 0; v < ModulationEngine::kMaxVoices; ++v)
+        voiceGains[static_cast<size_t>(v)] = v < voicesVal ? 1.0f / static_cast<float>(voicesVal) : 0.0f;
+
+    // Pick the specialized kernel once; the sample loops inside are branch-free.
+    // HQ keeps the saturation stage in the path while warmth is off so latency stays fixed.
+    const bool saturate = params.warmthActive || quality != WarmthQuality::eco;
+    derived.floatKernels.mono = getKernel<float>(modeVal == 2, shapeVal, saturate, 1, interpolation);
+    derived.floatKernels.stereo = getKernel<float>(modeVal == 2, shapeVal, saturate, 2, interpolation);
+    derived.doubleKernels.mono = getKernel<double>(modeVal == 2, shapeVal, saturate, 1, interpolation);
+    derived.doubleKernels.stereo = getKernel<double>(modeVal == 2, shapeVal, saturate, 2, interpolation);
+}
 
-        // Update LFO phases with stereo offset
-        lfoPhase[0] += lfoInc;
-        if (lfoPhase[0] >= 1.0f) lfoPhase[0] -= 1.0f;
-        lfoPhase[1] = lfoPhase[0] + stereoPhaseVal;
-        if (lfoPhase[1] >= 1.0f) lfoPhase[1] -= 1.0f;
+void SwayAudioProcessor::timerCallback()
+{
+    const int latency = reportedLatency.load();
+    if (latency != getLatencySamples())
+        setLatencySamples(latency);
+}
 
-        float wetL = 0.0f, wetR = 0.0f;
+void SwayAudioProcessor::parameterChanged(const juce::String&, float)
+{
+    // May run on the audio thread during automation: only note that something changed
+    parameterVersion.fetch_add(1, std::memory_order_release);
+}
 
-        if (modeVal == 2)  // Phaser
-        {
-            // Phaser: allpass cascade with modulated coefficients
-            const float minFreq = 200.0f;
-            const float maxFreq = 4000.0f + colorVal * 4000.0f;
+bool SwayAudioProcessor::isVisualizerSnapshotDue(int numSamples)
+{
+    samplesUntilSnapshot -= numSamples;
+    if (samplesUntilSnapshot > 0)
+        return false;
+
+    // Paced by audio time, so the rate holds whatever the host block size
+    const int period = juce::jmax(1, static_cast<int>(currentSampleRate / kVisualizerRateHz));
+    samplesUntilSnapshot = juce::jmax(samplesUntilSnapshot + period, 1);
+    return true;
+}
 
-            float inL = inputL[i] + feedbackSample[0] * curFeedback * 0.7f;
-            float inR = inputR[i] + feedbackSample[1] * curFeedback * 0.7f;
+void SwayAudioProcessor::pushVisualizerSnapshot(float rms, int mode, int shape, bool isBypassed,
+                                                float depth, int numVoices, float spread)
+{
+    VisualizerSnapshot snapshot;
+    snapshot.rms = rms;
+    snapshot.mode = mode;
+    snapshot.bypassed = isBypassed;
+    // The front pair's LFO
+    const auto& front = modulation[0];
+    snapshot.lfoPhase = front.getLfoPhase(0);
+    snapshot.lfoValue = front.getLfoValue(shape, 0);
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        const float lfo = front.getLfoValue(shape, ch);
+        snapshot.stereoPhase[ch] = lfo * 0.5f + 0.5f;
+        snapshot.modDepth[ch] = std::abs(lfo) * depth;
+    }
 
-            for (int s = 0; s < stagesVal; ++s)
-            {
-                // Each stage modulated with phase offset
-                const float stagePhase = static_cast<float>(s) / static_cast<float>(stagesVal);
-                float modL = lfoL * std::sin(stagePhase * juce::MathConstants<float>::pi);
-                float modR = lfoR * std::sin(stagePhase * juce::MathConstants<float>::pi);
-
-                const float freqL = minFreq + (maxFreq - minFreq) * (0.5f + modL * curDepth * 0.5f);
-                const float freqR = minFreq + (maxFreq - minFreq) * (0.5f + modR * curDepth * 0.5f);
-
-                // Allpass coefficient from frequency
-                const float coeffL = (std::tan(juce::MathConstants<float>::pi * freqL / sampleRate) - 1.0f) /
-                                     (std::tan(juce::MathConstants<float>::pi * freqL / sampleRate) + 1.0f);
-                const float coeffR = (std::tan(juce::MathConstants<float>::pi * freqR / sampleRate) - 1.0f) /
-                                     (std::tan(juce::MathConstants<float>::pi * freqR / sampleRate) + 1.0f);
-
-                inL = phaserStages[0][s].process(inL, coeffL);
-                inR = phaserStages[1][s].process(inR, coeffR);
-            }
+    // Same per-voice offsets the delay taps use
+    snapshot.numVoices = juce::jlimit(1, ModulationEngine::kMaxVoices, numVoices);
+    for (int v = 0; v < snapshot.numVoices; ++v)
+        snapshot.voicePhases[static_cast<size_t>(v)] = FastMath::wrap(
+            snapshot.lfoPhase + static_cast<float>(v) / static_cast<float>(snapshot.numVoices) * spread);
+
+    visualizerFifo.push(snapshot);
+}
+
+template <typename SampleType, bool IsPhaser, int Shape, bool Saturate, int NumChannels, DelayInterpolation Interpolation>
+void SwayAudioProcessor::processKernel(int pairIndex, SampleType* left, SampleType* right,
+                                       int numSamples, const KernelParams& params)
+{
+    // In place: each interval's input is read before its output is written
+    const SampleType* inputL = left;
+    const SampleType* inputR = NumChannels > 1 ? right : left;
+    SampleType* outputL = left;
+    SampleType* outputR = NumChannels > 1 ? right : nullptr;
+
+    auto& pair = getChannelPairs<SampleType>()[static_cast<size_t>(pairIndex)];
+    auto& pairModulation = modulation[static_cast<size_t>(pairIndex)];
+    auto& delayLine = pair.delayLine;
+    auto& warmthSaturator = pair.warmthSaturator;
+    SampleType* feedbackSample = pair.feedbackSample;
+
+    const int controlStep = pairModulation.getControlInterval();
+
+    for (int blockStart = 0; blockStart < numSamples; blockStart += controlStep)
+    {
+        const int blockLength = juce::jmin(controlStep, numSamples - blockStart);
+        const float blockScale = 1.0f / static_cast<float>(blockLength);
+
+        // Control-rate update: LFO, delay times and allpass coefficients
+        const float curRate = rateSmoothed.skip(blockLength);
+        const float curDepth = depthSmoothed.skip(blockLength);
+        pairModulation.advance<IsPhaser, Shape, NumChannels>(params.modSettings, curRate, curDepth, blockLength);
+
+        // Linear smoothers are exact when sampled at the interval edges
+        const float curFeedback = feedbackSmoothed.getCurrentValue();
+        float curMix = mixSmoothed.getCurrentValue();
+        const float feedbackInc = (feedbackSmoothed.skip(blockLength) - curFeedback) * blockScale;
+        const float mixInc = (mixSmoothed.skip(blockLength) - curMix) * blockScale;
+
+        SampleType wetL[ModulationEngine::kMaxControlInterval];
+        SampleType wetR[ModulationEngine::kMaxControlInterval];
 
-            wetL = inL;
-            wetR = inR;
-            feedbackSample[0] = wetL;
-            feedbackSample[1] = wetR;
+        if constexpr (IsPhaser)
+        {
+            // Phaser: allpass cascade with modulated coefficients. L and R run as
+            // two lanes of one SIMD register, so a mono cascade would cost the same
+            // per sample; mono feeds L into both lanes and discards wetR.
+            typename PhaserCascade<SampleType>::Block phaserBlock;
+            phaserBlock.inputL = inputL + blockStart;
+            phaserBlock.inputR = inputR + blockStart;
+            phaserBlock.wetL = wetL;
+            phaserBlock.wetR = wetR;
+            phaserBlock.numSamples = blockLength;
+            phaserBlock.coeffL = pairModulation.coefficient[0].data();
+            phaserBlock.coeffR = pairModulation.coefficient[1].data();
+            phaserBlock.coeffIncL = pairModulation.coefficientIncrement[0].data();
+            phaserBlock.coeffIncR = pairModulation.coefficientIncrement[1].data();
+            phaserBlock.feedback = curFeedback;
+            phaserBlock.feedbackInc = feedbackInc;
+            phaserBlock.feedbackSample = feedbackSample;
+
+            if constexpr (std::is_same_v<SampleType, double>)
+                (pair.phaserCascade.*params.processPhaserDouble)(phaserBlock);
+            else
+                (pair.phaserCascade.*params.processPhaser)(phaserBlock);
         }
         else  // Chorus, Flanger, Ensemble
         {
-            // Write to delay lines
-            for (int v = 0; v < voicesVal; ++v)
-            {
-                delayLines[v * 2][writePos] = inputL[i] + feedbackSample[0] * curFeedback;
-                delayLines[v * 2 + 1][writePos] = inputR[i] + feedbackSample[1] * curFeedback;
-            }
+            auto& delayL = pairModulation.delaySamples[0];
+            auto& delayR = pairModulation.delaySamples[1];
+            const auto& delayIncL = pairModulation.delayIncrement[0];
+            const auto& delayIncR = pairModulation.delayIncrement[1];
+            float fb = curFeedback;
 
-            // Read from delay lines with modulation
-            for (int v = 0; v < voicesVal; ++v)
+            for (int i = 0; i < blockLength; ++i)
             {
-                // Voice-specific LFO offset for richer sound
-                const float voiceOffset = static_cast<float>(v) / static_cast<float>(voicesVal);
-                float voiceLfoL = getSineLFO(std::fmod(lfoPhase[0] + voiceOffset * spreadVal, 1.0f));
-                float voiceLfoR = getSineLFO(std::fmod(lfoPhase[1] + voiceOffset * spreadVal, 1.0f));
-
-                // Calculate delay time
-                const float delayMsL = minDelay + (maxDelay - minDelay) * (0.5f + voiceLfoL * curDepth * 0.5f);
-                const float delayMsR = minDelay + (maxDelay - minDelay) * (0.5f + voiceLfoR * curDepth * 0.5f);
-
-                const float delaySamplesL = delayMsL * sampleRate / 1000.0f;
-                const float delaySamplesR = delayMsR * sampleRate / 1000.0f;
-
-                // Interpolated read
-                float readPosL = static_cast<float>(writePos) - delaySamplesL;
-                float readPosR = static_cast<float>(writePos) - delaySamplesR;
-                while (readPosL < 0) readPosL += kMaxDelaySize;
-                while (readPosR < 0) readPosR += kMaxDelaySize;
-
-                const int idxL = static_cast<int>(readPosL) % kMaxDelaySize;
-                const int idxL1 = (idxL + 1) % kMaxDelaySize;
-                const float fracL = readPosL - std::floor(readPosL);
-
-                const int idxR = static_cast<int>(readPosR) % kMaxDelaySize;
-                const int idxR1 = (idxR + 1) % kMaxDelaySize;
-                const float fracR = readPosR - std::floor(readPosR);
-
-                wetL += (delayLines[v * 2][idxL] * (1.0f - fracL) + delayLines[v * 2][idxL1] * fracL);
-                wetR += (delayLines[v * 2 + 1][idxR] * (1.0f - fracR) + delayLines[v * 2 + 1][idxR1] * fracR);
+                fb += feedbackInc;
+
+                // Write to delay line
+                if constexpr (NumChannels > 1)
+                    delayLine.write(inputL[blockStart + i] + feedbackSample[0] * fb,
+                                    inputR[blockStart + i] + feedbackSample[1] * fb);
+                else
+                    delayLine.write(inputL[blockStart + i] + feedbackSample[0] * fb);
+
+                // One modulated tap per voice, normalized by voice count; mono reads L only
+                wetL[i] = delayLine.template readVoices<Interpolation>(0, delayL.data(), delayIncL.data(), voiceGains.data(), params.numVoices);
+                feedbackSample[0] = wetL[i];
+
+                if constexpr (NumChannels > 1)
+                {
+                    wetR[i] = delayLine.template readVoices<Interpolation>(1, delayR.data(), delayIncR.data(), voiceGains.data(), params.numVoices);
+                    feedbackSample[1] = wetR[i];
+                }
+
+                delayLine.advance();
             }
-
-            // Normalize by voice count
-            wetL /= static_cast<float>(voicesVal);
-            wetR /= static_cast<float>(voicesVal);
-
-            feedbackSample[0] = wetL;
-            feedbackSample[1] = wetR;
         }
 
         // Apply warmth (soft saturation)
-        if (warmthVal > 0.01f)
+        if constexpr (Saturate)
         {
-            const float drive = 1.0f + warmthVal * 3.0f;
-            wetL = std::tanh(wetL * drive) / drive;
-            wetR = std::tanh(wetR * drive) / drive;
+            warmthSaturator.process(wetL, NumChannels > 1 ? wetR : nullptr, blockLength,
+                                    params.drive, params.warmthActive);
+
+            // The input of this interval has been consumed, so the dry path can be delayed in place
+            warmthSaturator.delayDry(outputL + blockStart,
+                                     NumChannels > 1 ? outputR + blockStart : nullptr, blockLength);
         }
 
-        // Stereo width
-        if (numChannels == 2 && std::abs(widthVal - 1.0f) > 0.01f)
+        const SampleType* dryL = outputL + blockStart;
+        const SampleType* dryR = NumChannels > 1 ? outputR + blockStart : dryL;
+        SampleType* outL = outputL + blockStart;
+        const auto width = static_cast<SampleType>(params.width);
+
+        for (int i = 0; i < blockLength; ++i)
         {
-            const float mid = (wetL + wetR) * 0.5f;
-            const float side = (wetL - wetR) * 0.5f * widthVal;
-            wetL = mid + side;
-            wetR = mid - side;
-        }
+            curMix += mixInc;
+            const auto mix = static_cast<SampleType>(curMix);
+            const auto dryGain = SampleType(1) - mix;
+
+            if constexpr (NumChannels == 2)
+            {
+                const SampleType l = wetL[i];
+                const SampleType r = wetR[i];
 
-        // Mix
-        outputL[i] = inputL[i] * (1.0f - curMix) + wetL * curMix;
-        outputR[i] = inputR[i] * (1.0f - curMix) + wetR * curMix;
+                // Stereo width
+                const SampleType mid = (l + r) * SampleType(0.5);
+                const SampleType side = (l - r) * SampleType(0.5) * width;
 
-        writePos = (writePos + 1) % kMaxDelaySize;
+                // Mix
+                outL[i] = dryL[i] * dryGain + (mid + side) * mix;
+                outputR[blockStart + i] = dryR[i] * dryGain + (mid - side) * mix;
+            }
+            else
+            {
+                juce::ignoreUnused(dryR);
+                outL[i] = dryL[i] * dryGain + wetL[i] * mix;
+            }
+        }
     }
+}
 
-    lfoPhaseVis.store(lfoPhase[0]);
-    modulationAmount.store(depthVal);
+template <typename SampleType, size_t... Index>
+constexpr std::array<SwayAudioProcessor::Kernel<SampleType>, sizeof...(Index)>
+    SwayAudioProcessor::makeKernelTable(std::index_sequence<Index...>)
+{
+    // Index bits: [6:5] interpolation, [4] phaser, [3:2] shape, [1] saturation stage,
+    // [0] stereo. The phaser has no taps, so all its entries share the linear kernels.
+    return { { &SwayAudioProcessor::processKernel<SampleType,
+                                                  ((Index >> 4) & 1) != 0,
+                                                  static_cast<int>((Index >> 2) & 3),
+                                                  ((Index >> 1) & 1) != 0,
+                                                  static_cast<int>(Index & 1) + 1,
+                                                  ((Index >> 4) & 1) != 0 ? DelayInterpolation::linear
+                                                                          : static_cast<DelayInterpolation>(Index >> 5)>... } };
+}
+
+template <typename SampleType>
+SwayAudioProcessor::Kernel<SampleType> SwayAudioProcessor::getKernel(bool isPhaser, int shape, bool saturate, int numChannels,
+                                                                      DelayInterpolation interpolation)
+{
+    static constexpr auto kernels = makeKernelTable<SampleType>(std::make_index_sequence<96>());
+
+    const auto index = (static_cast<unsigned>(interpolation) << 5)
+                     | (isPhaser ? 16u : 0u)
+                     | (static_cast<unsigned>(juce::jlimit(0, 3, shape)) << 2)
+                     | (saturate ? 2u : 0u)
+                     | (numChannels > 1 ? 1u : 0u);
+    return kernels[index];
 }
 
 juce::AudioProcessorEditor* SwayAudioProcessor::createEditor()
 {
+#if SWAY_HEADLESS
+    return nullptr;
+#else
     return new SwayAudioProcessorEditor(*this);
+#endif
 }
 
 void SwayAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
     auto state = apvts.copyState();
     state.setProperty("stateVersion", kStateVersion, nullptr);
+    state.setProperty("randomSeed", static_cast<juce::int64>(randomSeed.load()), nullptr);
     std::unique_ptr<juce::XmlElement> xml(state.createXml());
     copyXmlToBinary(*xml, destData);
 }
@@ -462,7 +921,11 @@ void SwayAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
     std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
     if (xml != nullptr && xml->hasTagName(apvts.state.getType()))
-        apvts.replaceState(juce::ValueTree::fromXml(*xml));
+    {
+        auto state = juce::ValueTree::fromXml(*xml);
+        randomSeed.store(static_cast<juce::uint32>(static_cast<juce::int64>(state.getProperty("randomSeed", 0))));
+        apvts.replaceState(state);
+    }
 }
 
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
@@ -2,8 +2,14 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_dsp/juce_dsp.h>
-#include <random>
 #include <array>
+#include <type_traits>
+#include <utility>
+#include "ModulationEngine.h"
+#include "StereoDelayLine.h"
+#include "PhaserCascade.h"
+#include "WarmthSaturator.h"
+#include "VisualizerFifo.h"
 
 #if HAS_PROJECT_DATA
 #include "ProjectData.h"
@@ -13,7 +19,9 @@
 #include <beatconnect/Activation.h>
 #endif
 
-class SwayAudioProcessor : public juce::AudioProcessor
+class SwayAudioProcessor : public juce::AudioProcessor,
+                           private juce::Timer,
+                           private juce::AudioProcessorValueTreeState::Listener
 {
 public:
     SwayAudioProcessor();
@@ -23,15 +31,23 @@ public:
     void releaseResources() override;
     bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock(juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+
+    // The DSP is templated on the sample type, so 64-bit hosts run without conversion
+    bool supportsDoublePrecisionProcessing() const override { return true; }
 
     juce::AudioProcessorEditor* createEditor() override;
+#if SWAY_HEADLESS
+    bool hasEditor() const override { return false; }
+#else
     bool hasEditor() const override { return true; }
+#endif
 
     const juce::String getName() const override { return JucePlugin_Name; }
     bool acceptsMidi() const override { return false; }
     bool producesMidi() const override { return false; }
     bool isMidiEffect() const override { return false; }
-    double getTailLengthSeconds() const override { return 0.5; }
+    double getTailLengthSeconds() const override { return kTailSeconds; }
 
     int getNumPrograms() override { return 1; }
     int getCurrentProgram() override { return 0; }
@@ -44,12 +60,20 @@ public:
 
     juce::AudioProcessorValueTreeState& getAPVTS() { return apvts; }
 
-    // Visualizer data
-    float getCurrentRMS() const { return currentRMS.load(); }
-    float getLfoPhase() const { return lfoPhaseVis.load(); }
-    float getModulationAmount() const { return modulationAmount.load(); }
-    int getCurrentMode() const { return currentMode.load(); }
-    bool isBypassed() const { return bypassed.load(); }
+    // Modulation control rate in samples; takes effect on the next prepareToPlay()
+    void setControlInterval(int numSamples) { controlInterval = numSamples; }
+    int getControlInterval() const { return controlInterval; }
+
+    // Random-shape seed, saved with the state; 0 picks a new sequence every session.
+    // A nonzero seed makes renders reproducible from the next prepareToPlay().
+    void setRandomSeed(juce::uint32 seed) { randomSeed.store(seed); }
+    juce::uint32 getRandomSeed() const { return randomSeed.load(); }
+
+    // True while the wet path is asleep on silent input. Written by the audio thread, readable from any.
+    bool isIdle() const { return idle.load(std::memory_order_relaxed); }
+
+    // Visualizer snapshots, pushed by processBlock at kVisualizerRateHz. Single consumer: the editor.
+    VisualizerFifo& getVisualizerFifo() { return visualizerFifo; }
 
     // BeatConnect integration
     bool hasActivationEnabled() const;
@@ -64,41 +88,187 @@ public:
 private:
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
     void loadProjectData();
+    void timerCallback() override;
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
+    bool isVisualizerSnapshotDue(int numSamples);
+    void pushVisualizerSnapshot(float rms, int mode, int shape, bool isBypassed, float depth, int numVoices, float spread);
+
+    // Up to 7.1.4. A pair slot per channel covers a layout with no L/R partners.
+    static constexpr int kMaxChannels = 12;
+    static constexpr int kMaxPairs = kMaxChannels;
+
+    // Per-block values shared by every kernel
+    struct KernelParams
+    {
+        ModulationEngine::Settings modSettings;
+        PhaserCascade<float>::ProcessFunction processPhaser = nullptr;
+        PhaserCascade<double>::ProcessFunction processPhaserDouble = nullptr;
+        int numVoices = 1;
+        float drive = 1.0f;     // warmth drive
+        bool warmthActive = false;
+        float width = 1.0f;     // stereo width, exactly 1 when inactive
+    };
+
+    // Audio state for up to two channels at one precision. Stereo runs one pair;
+    // larger layouts are split by routeChannels() and each wet pair's LFO is
+    // rotated further around the cycle.
+    template <typename SampleType>
+    struct ChannelPair
+    {
+        // Delay line for chorus/flanger, shared by all voices as modulated taps
+        StereoDelayLine<SampleType> delayLine;
+
+        // Allpass cascade for phaser (2-12 stages, stereo)
+        PhaserCascade<SampleType> phaserCascade;
+
+        // Warmth on the wet signal (ADAA or oversampled) and the matching dry delay
+        WarmthSaturator<SampleType> warmthSaturator;
+
+        // Feedback state
+        SampleType feedbackSample[2] = { SampleType(0), SampleType(0) };
+    };
+
+    template <typename SampleType>
+    using ChannelPairs = std::array<ChannelPair<SampleType>, kMaxPairs>;
+
+    // Only the pairs of the host's processing precision are prepared
+    template <typename SampleType>
+    ChannelPairs<SampleType>& getChannelPairs()
+    {
+        if constexpr (std::is_same_v<SampleType, double>)
+            return doublePairs;
+        else
+            return floatPairs;
+    }
+
+    // Drops delay, allpass, feedback and warmth state; the next block starts from silence
+    template <typename SampleType>
+    void clearChannelPairs();
+
+    // Prepares numPairs pairs at the given warmth quality and returns its latency
+    template <typename SampleType>
+    int prepareChannelPairs(double sampleRate, WarmthQuality quality);
+
+    // Sets the quality on every prepared pair and returns the resulting latency
+    template <typename SampleType>
+    int setWarmthQuality(WarmthQuality quality);
 
-    // LFO shape generators
-    float getSineLFO(float phase);
-    float getTriangleLFO(float phase);
-    float getSquareLFO(float phase);
-    float getRandomLFO(float phase, int channel);
+    // processBlock for either precision
+    template <typename SampleType>
+    void process(juce::AudioBuffer<SampleType>& buffer);
+
+    // processBlock body for one pair, specialized on sample type, mode family, LFO
+    // shape, saturation stage on/off, channel count (right is nullptr for mono) and
+    // tap interpolation; getKernel() picks one per pair
+    template <typename SampleType, bool IsPhaser, int Shape, bool Saturate, int NumChannels, DelayInterpolation Interpolation>
+    void processKernel(int pairIndex, SampleType* left, SampleType* right, int numSamples, const KernelParams& params);
+
+    template <typename SampleType>
+    using Kernel = void (SwayAudioProcessor::*)(int, SampleType*, SampleType*, int, const KernelParams&);
+
+    template <typename SampleType>
+    static Kernel<SampleType> getKernel(bool isPhaser, int shape, bool saturate, int numChannels,
+                                        DelayInterpolation interpolation);
+
+    template <typename SampleType, size_t... Index>
+    static constexpr std::array<Kernel<SampleType>, sizeof...(Index)> makeKernelTable(std::index_sequence<Index...>);
+
+    template <typename SampleType>
+    struct KernelChoice
+    {
+        Kernel<SampleType> mono = nullptr;
+        Kernel<SampleType> stereo = nullptr;
+    };
+
+    // Everything processBlock derives from the non-smoothed parameters: kernel
+    // choice, delay ranges, phaser bounds, voice offsets and gains, warmth quality
+    // and tap interpolation
+    struct DerivedState
+    {
+        KernelParams params;
+        KernelChoice<float> floatKernels;
+        KernelChoice<double> doubleKernels;
+        int mode = 0;
+        int shape = 0;
+        float spread = 0.0f;
+        DelayInterpolation interpolation = DelayInterpolation::linear;
+        bool bypassed = false;
+    };
+
+    // Rebuilds derived (and voiceGains) from the current parameter values
+    void updateDerivedState();
 
     juce::AudioProcessorValueTreeState apvts;
 
-    // Delay lines for chorus/flanger (per voice, stereo)
-    static constexpr int kMaxVoices = 8;
-    static constexpr int kMaxDelaySize = 4096;  // ~90ms at 44.1kHz
-    std::array<std::array<float, kMaxDelaySize>, kMaxVoices * 2> delayLines {};
-    int writePos = 0;
-
-    // Allpass filters for phaser (12 stages max, stereo)
-    struct AllpassStage {
-        float z1 = 0.0f;
-        float process(float input, float coeff) {
-            float output = -input * coeff + z1;
-            z1 = output * coeff + input;
-            return output;
-        }
+    // Raw parameter values, resolved once so processBlock does no string lookups
+    struct ParameterPointers
+    {
+        std::atomic<float>* mode = nullptr;
+        std::atomic<float>* rate = nullptr;
+        std::atomic<float>* depth = nullptr;
+        std::atomic<float>* shape = nullptr;
+        std::atomic<float>* stereoPhase = nullptr;
+        std::atomic<float>* feedback = nullptr;
+        std::atomic<float>* voices = nullptr;
+        std::atomic<float>* spread = nullptr;
+        std::atomic<float>* warmth = nullptr;
+        std::atomic<float>* warmthQuality = nullptr;
+        std::atomic<float>* interpolation = nullptr;
+        std::atomic<float>* stages = nullptr;
+        std::atomic<float>* color = nullptr;
+        std::atomic<float>* mix = nullptr;
+        std::atomic<float>* width = nullptr;
+        std::atomic<float>* bypass = nullptr;
     };
-    std::array<std::array<AllpassStage, 12>, 2> phaserStages {};
+    ParameterPointers rawParameters;
 
-    // LFO state
-    float lfoPhase[2] = { 0.0f, 0.0f };
-    std::mt19937 rng;
-    float randomLfoValue[2] = { 0.0f, 0.0f };
-    float randomLfoTarget[2] = { 0.0f, 0.0f };
-    float lastRandomPhase = 0.0f;
+    // Bumped by every parameter change (any thread). processBlock rebuilds the
+    // derived state only when it differs from derivedVersion.
+    std::atomic<juce::uint32> parameterVersion { 0 };
+    juce::uint32 derivedVersion = 0;
+    bool derivedValid = false;
+    DerivedState derived;
 
-    // Feedback state
-    float feedbackSample[2] = { 0.0f, 0.0f };
+    static constexpr float kMaxDelayMs = 30.0f;  // longest mode range (chorus)
+
+    // Which main-bus channels each pair processes, set from the bus's channel
+    // types: left/right partners (L/R, Ls/Rs, Ltf/Rtf, ...) share a pair, centre
+    // channels run alone through the mono kernel, and LFE channels stay dry,
+    // only delayed to match the latency. Channels of any other type (discrete
+    // layouts) are paired in bus order.
+    struct PairRouting
+    {
+        int left = 0;
+        int right = -1;     // -1 for a mono pair
+        bool dry = false;
+    };
+
+    void routeChannels(const juce::AudioChannelSet& layout);
+
+    // Pairs beyond numPairs are never prepared and hold no buffers
+    ChannelPairs<float> floatPairs;
+    ChannelPairs<double> doublePairs;
+    std::array<PairRouting, kMaxPairs> pairRouting {};
+    int numPairs = 1;
+
+    // LFO, delay-time and allpass-coefficient ramps at control rate, one per pair.
+    // Control data, so shared by both precisions.
+    std::array<ModulationEngine, kMaxPairs> modulation;
+
+    // Per-voice tap gain: 1/voices for active voices, 0 for padding lanes
+    static_assert(ModulationEngine::kMaxVoices % StereoDelayLine<float>::kLanes == 0,
+                  "voice arrays must hold a whole number of SIMD registers");
+    static_assert(ModulationEngine::kMaxVoices <= StereoDelayLine<float>::kMaxTaps,
+                  "every voice needs its own allpass state");
+    alignas(StereoDelayLine<float>::kAlignment) std::array<float, ModulationEngine::kMaxVoices> voiceGains {};
+
+    int controlInterval = ModulationEngine::kDefaultControlInterval;
+    std::atomic<juce::uint32> randomSeed { 0 };
+
+    // Warmth latency as set by the audio thread; every pair runs the same quality.
+    // The message thread polls it and tells the host, since the audio thread may not post messages.
+    static constexpr int kLatencyPollRateHz = 10;
+    std::atomic<int> reportedLatency { 0 };
 
     // Parameter smoothing
     juce::SmoothedValue<float> rateSmoothed;
@@ -108,12 +278,19 @@ private:
 
     double currentSampleRate = 44100.0;
 
+    // Idle mode. Once input, output and feedback have stayed below
+    // kSilenceThreshold for the tail length, the tail has died away: the
+    // channel state is cleared and blocks skip the kernels until input returns.
+    static constexpr double kTailSeconds = 0.5;
+    static constexpr float kSilenceThreshold = 1.0e-5f;    // -100 dBFS
+    int samplesUntilIdle = 0;
+    int silentSamples = 0;
+    std::atomic<bool> idle { false };    // only the audio thread writes; nothing else is published with it
+
     // Visualizer data
-    std::atomic<float> currentRMS { 0.0f };
-    std::atomic<float> lfoPhaseVis { 0.0f };
-    std::atomic<float> modulationAmount { 0.0f };
-    std::atomic<int> currentMode { 0 };
-    std::atomic<bool> bypassed { false };
+    static constexpr int kVisualizerRateHz = 60;
+    VisualizerFifo visualizerFifo;
+    int samplesUntilSnapshot = 0;
 
     // BeatConnect data
     juce::String pluginId;
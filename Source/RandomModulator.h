@@ -0,0 +1,97 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <cmath>
+
+// Smoothed random LFO for the Random shape.
+//
+// Each channel draws a new target from its own PCG32 stream whenever its own
+// LFO phase wraps, and glides towards it through a one-pole whose time
+// constant is fixed in seconds, so the glide is the same at every sample rate
+// and control interval. Drawing is a multiply and a few shifts; nothing here
+// allocates or touches libm except getSmoothing().
+class RandomModulator
+{
+public:
+    // The old 0.01-per-sample glide at 44.1 kHz, the rate it was tuned at
+    static constexpr double kGlideSeconds = 100.0 / 44100.0;
+
+    // PCG32 (XSH RR): 16 bytes of state, independent sequences per stream
+    class Generator
+    {
+    public:
+        void seed(juce::uint64 initialState, juce::uint64 stream)
+        {
+            state = 0;
+            increment = (stream << 1) | 1;
+            next();
+            state += initialState;
+            next();
+        }
+
+        juce::uint32 next()
+        {
+            const auto old = state;
+            state = old * 6364136223846793005ULL + increment;
+            const auto shifted = static_cast<juce::uint32>(((old >> 18) ^ old) >> 27);
+            const auto rotation = static_cast<juce::uint32>(old >> 59);
+            return (shifted >> rotation) | (shifted << ((32 - rotation) & 31));
+        }
+
+        // Uniform in [-1, 1), 24 bits
+        float nextBipolar()
+        {
+            return static_cast<float>(next() >> 8) * (2.0f / 16777216.0f) - 1.0f;
+        }
+
+    private:
+        juce::uint64 state = 0;
+        juce::uint64 increment = 1;
+    };
+
+    void prepare(double sampleRate)
+    {
+        glideSamples = kGlideSeconds * sampleRate;
+    }
+
+    // Restarts both channels' sequences from seed, on PCG streams 2 * stream and
+    // 2 * stream + 1, so modulators sharing a seed stay independent
+    void reset(juce::uint32 seed, int stream = 0)
+    {
+        for (size_t ch = 0; ch < 2; ++ch)
+        {
+            generators[ch].seed(seed, static_cast<juce::uint64>(stream) * 2 + ch);
+            value[ch] = target[ch] = 0.0f;
+            lastPhase[ch] = 0.0f;
+        }
+    }
+
+    // One-pole step covering numSamples; compute once per interval length
+    float getSmoothing(int numSamples) const
+    {
+        return static_cast<float>(1.0 - std::exp(-static_cast<double>(numSamples) / glideSamples));
+    }
+
+    // Moves one channel on to its LFO phase now, numSamples (smoothing, from
+    // getSmoothing()) after the previous call
+    void advance(int channel, float phase, float smoothing)
+    {
+        const auto ch = static_cast<size_t>(channel);
+
+        // New target each cycle
+        if (phase < lastPhase[ch])
+            target[ch] = generators[ch].nextBipolar();
+        lastPhase[ch] = phase;
+
+        value[ch] += (target[ch] - value[ch]) * smoothing;
+    }
+
+    float getValue(int channel) const { return value[static_cast<size_t>(channel)]; }
+
+private:
+    double glideSamples = kGlideSeconds * 44100.0;
+
+    std::array<Generator, 2> generators;
+    std::array<float, 2> value {}, target {}, lastPhase {};
+};
@@ -0,0 +1,396 @@
+#include "RealtimeSafety.h"
+
+#if SWAY_RT_CHECKS
+
+#if ! SWAY_HEADLESS
+ #error "SWAY_RT_CHECKS replaces the process allocator; build it into the headless tools only"
+#endif
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+#if defined(__GLIBC__)
+ #include <dlfcn.h>
+ #include <poll.h>
+ #include <pthread.h>
+ #include <semaphore.h>
+ #include <sys/select.h>
+ #include <time.h>
+ #include <unistd.h>
+#endif
+
+namespace
+{
+    constexpr int kMaxReports = 8;
+
+    // Trivially initialized, so reading them never allocates, even from inside malloc
+    thread_local const char* currentCallback = nullptr;    // innermost scope, or nullptr
+    thread_local bool suppressed = false;                  // inside a report or a forwarded call
+
+    std::atomic<int> numViolations { 0 };
+
+    // Calls made by the checker itself (reports, forwarding) are not the callback's
+    class Suppress
+    {
+    public:
+        Suppress() : previous(suppressed) { suppressed = true; }
+        ~Suppress() { suppressed = previous; }
+
+    private:
+        const bool previous;
+    };
+
+    void noteCall(const char* call)
+    {
+        if (currentCallback == nullptr || suppressed)
+            return;
+
+        const Suppress suppress;
+        const int count = ++numViolations;
+
+        if (count <= kMaxReports)
+            std::cerr << "realtime violation: " << call << " inside " << currentCallback << "\n"
+                      << juce::SystemStats::getStackBacktrace() << "\n";
+        else if (count == kMaxReports + 1)
+            std::cerr << "realtime violation: further reports suppressed\n";
+    }
+
+    void* allocate(std::size_t size, std::size_t alignment = 0)
+    {
+        const Suppress suppress;
+        void* memory = nullptr;
+
+        if (alignment <= alignof(std::max_align_t))
+            memory = std::malloc(size != 0 ? size : 1);
+        else
+        {
+           #if JUCE_WINDOWS
+            memory = _aligned_malloc(size != 0 ? size : 1, alignment);
+           #else
+            if (posix_memalign(&memory, alignment, size != 0 ? size : 1) != 0)
+                memory = nullptr;
+           #endif
+        }
+
+        return memory;
+    }
+
+    void release(void* memory, std::size_t alignment = 0)
+    {
+        const Suppress suppress;
+
+       #if JUCE_WINDOWS
+        if (alignment > alignof(std::max_align_t))
+            return _aligned_free(memory);
+       #else
+        juce::ignoreUnused(alignment);
+       #endif
+
+        std::free(memory);
+    }
+
+   #if defined(__GLIBC__)
+    // The next definition of a replaced function, looked up once
+    template <typename Function>
+    Function next(std::atomic<void*>& slot, const char* name)
+    {
+        auto* function = slot.load(std::memory_order_acquire);
+
+        if (function == nullptr)
+        {
+            const Suppress suppress;
+            function = dlsym(RTLD_NEXT, name);
+            slot.store(function, std::memory_order_release);
+        }
+
+        return reinterpret_cast<Function>(function);
+    }
+   #endif
+}
+
+namespace RealtimeSafety
+{
+    ScopedRealtime::ScopedRealtime(const char* callback)
+        : previous(currentCallback)
+    {
+        currentCallback = callback;
+    }
+
+    ScopedRealtime::~ScopedRealtime()
+    {
+        currentCallback = previous;
+    }
+
+    int getNumViolations()
+    {
+        return numViolations.load();
+    }
+
+    void resetViolations()
+    {
+        numViolations.store(0);
+    }
+}
+
+//==============================================================================
+// C++ allocation, every platform
+void* operator new(std::size_t size)
+{
+    noteCall("operator new");
+    if (auto* memory = allocate(size))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    noteCall("operator new[]");
+    if (auto* memory = allocate(size))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    noteCall("operator new");
+    if (auto* memory = allocate(size, static_cast<std::size_t>(alignment)))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    noteCall("operator new[]");
+    if (auto* memory = allocate(size, static_cast<std::size_t>(alignment)))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    noteCall("operator new");
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    noteCall("operator new[]");
+    return allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    noteCall("operator new");
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    noteCall("operator new[]");
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* memory) noexcept                                   { noteCall("operator delete"); release(memory); }
+void operator delete[](void* memory) noexcept                                 { noteCall("operator delete[]"); release(memory); }
+void operator delete(void* memory, std::size_t) noexcept                      { noteCall("operator delete"); release(memory); }
+void operator delete[](void* memory, std::size_t) noexcept                    { noteCall("operator delete[]"); release(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept            { noteCall("operator delete"); release(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept          { noteCall("operator delete[]"); release(memory); }
+
+void operator delete(void* memory, std::align_val_t alignment) noexcept
+{
+    noteCall("operator delete");
+    release(memory, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* memory, std::align_val_t alignment) noexcept
+{
+    noteCall("operator delete[]");
+    release(memory, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t alignment) noexcept
+{
+    noteCall("operator delete");
+    release(memory, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* memory, std::size_t, std::align_val_t alignment) noexcept
+{
+    noteCall("operator delete[]");
+    release(memory, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* memory, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    noteCall("operator delete");
+    release(memory, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* memory, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    noteCall("operator delete[]");
+    release(memory, static_cast<std::size_t>(alignment));
+}
+
+//==============================================================================
+#if defined(__GLIBC__)
+// C allocation: glibc exports its allocator under __libc_ names as well
+extern "C"
+{
+    void* __libc_malloc(size_t);
+    void* __libc_calloc(size_t, size_t);
+    void* __libc_realloc(void*, size_t);
+    void* __libc_memalign(size_t, size_t);
+    void __libc_free(void*);
+
+    void* malloc(size_t size) noexcept
+    {
+        noteCall("malloc");
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t count, size_t size) noexcept
+    {
+        noteCall("calloc");
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* memory, size_t size) noexcept
+    {
+        noteCall("realloc");
+        return __libc_realloc(memory, size);
+    }
+
+    void free(void* memory) noexcept
+    {
+        noteCall("free");
+        __libc_free(memory);
+    }
+
+    void* memalign(size_t alignment, size_t size) noexcept
+    {
+        noteCall("memalign");
+        return __libc_memalign(alignment, size);
+    }
+
+    void* aligned_alloc(size_t alignment, size_t size) noexcept
+    {
+        noteCall("aligned_alloc");
+        return __libc_memalign(alignment, size);
+    }
+
+    int posix_memalign(void** memory, size_t alignment, size_t size) noexcept
+    {
+        noteCall("posix_memalign");
+        *memory = __libc_memalign(alignment, size);
+        return *memory != nullptr ? 0 : ENOMEM;
+    }
+
+    // Locks and waits
+    int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept
+    {
+        static std::atomic<void*> real { nullptr };
+        noteCall("pthread_mutex_lock");
+        return next<decltype(&pthread_mutex_lock)>(real, "pthread_mutex_lock")(mutex);
+    }
+
+    int pthread_rwlock_rdlock(pthread_rwlock_t* lock) noexcept
+    {
+        static std::atomic<void*> real { nullptr };
+        noteCall("pthread_rwlock_rdlock");
+        return next<decltype(&pthread_rwlock_rdlock)>(real, "pthread_rwlock_rdlock")(lock);
+    }
+
+    int pthread_rwlock_wrlock(pthread_rwlock_t* lock) noexcept
+    {
+        static std::atomic<void*> real { nullptr };
+        noteCall("pthread_rwlock_wrlock");
+        return next<decltype(&pthread_rwlock_wrlock)>(real, "pthread_rwlock_wrlock")(lock);
+    }
+
+    int pthread_cond_wait(pthread_cond_t* condition, pthread_mutex_t* mutex)
+    {
+        static std::atomic<void*> real { nullptr };
+        noteCall("pthread_cond_wait");
+        return next<decltype(&pthread_cond_wait)>(real, "pthread_cond_wait")(condition, mutex);
+    }
+
+    int pthread_cond_timedwait(pthread_cond_t* condition, pthread_mutex_t* mutex, const timespec* deadline)
+    {
+        static std::atomic<void*> real { nullptr };
+        noteCall("pthread_cond_timedwait");
+        return next<decltype(&pthread_cond_timedwait)>(real, "pthread_cond_timedwait")(condition, mutex, deadline);
+    }
+
+    int sem_wait(sem_t* semaphore)
+    {
+        static std::atomic<void*> real { nullptr };
+        noteCall("sem_wait");
+        return next<decltype(&sem_wait)>(real, "sem_wait")(semaphore);
+    }
+
+    // Sleeping, polling and I/O
+    int nanosleep(const timespec* duration, timespec* remaining)
+    {
+        static std::atomic<void*> real { nullptr };
+        noteCall("nanosleep");
+        return next<decltype(&nanosleep)>(real, "nanosleep")(duration, remaining);
+    }
+
+    int clock_nanosleep(clockid_t clock, int flags, const timespec* duration, timespec* remaining)
+    {
+        static std::atomic<void*> real { nullptr };
+        noteCall("clock_nanosleep");
+        return next<decltype(&clock_nanosleep)>(real, "clock_nanosleep")(clock, flags, duration, remaining);
+    }
+
+    int usleep(useconds_t microseconds)
+    {
+        static std::atomic<void*> real { nullptr };
+        noteCall("usleep");
+        return next<decltype(&usleep)>(real, "usleep")(microseconds);
+    }
+
+    unsigned int sleep(unsigned int seconds)
+    {
+        static std::atomic<void*> real { nullptr };
+        noteCall("sleep");
+        return next<decltype(&sleep)>(real, "sleep")(seconds);
+    }
+
+    int poll(pollfd* descriptors, nfds_t count, int timeout)
+    {
+        static std::atomic<void*> real { nullptr };
+        noteCall("poll");
+        return next<decltype(&poll)>(real, "poll")(descriptors, count, timeout);
+    }
+
+    int select(int count, fd_set* readable, fd_set* writable, fd_set* failed, timeval* timeout)
+    {
+        static std::atomic<void*> real { nullptr };
+        noteCall("select");
+        return next<decltype(&select)>(real, "select")(count, readable, writable, failed, timeout);
+    }
+
+    ssize_t read(int descriptor, void* buffer, size_t size)
+    {
+        static std::atomic<void*> real { nullptr };
+        noteCall("read");
+        return next<decltype(&read)>(real, "read")(descriptor, buffer, size);
+    }
+
+    ssize_t write(int descriptor, const void* buffer, size_t size)
+    {
+        static std::atomic<void*> real { nullptr };
+        noteCall("write");
+        return next<decltype(&write)>(real, "write")(descriptor, buffer, size);
+    }
+}
+#endif
+
+#endif
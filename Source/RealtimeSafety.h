@@ -0,0 +1,52 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+// Opt-in audio-thread checker for the headless tools (CMake SWAY_RT_CHECKS).
+//
+// A ScopedRealtime marks the calling thread as inside a realtime callback.
+// In a checked build RealtimeSafety.cpp replaces operator new/delete and, on
+// Linux with glibc, the malloc family, pthread locks and waits, and sleeping,
+// polling and read/write calls. Reaching any of them inside a scope reports
+// the callback, the call and a stack trace to stderr. Everything is forwarded
+// to the real implementation afterwards, so a checked run still produces the
+// same audio.
+//
+// Normal builds (and the plugin always) get an empty scope and replace nothing.
+namespace RealtimeSafety
+{
+#if SWAY_RT_CHECKS
+    class ScopedRealtime
+    {
+    public:
+        // callback names the entry point in reports, e.g. "processBlock"; must outlive the scope
+        explicit ScopedRealtime(const char* callback);
+        ~ScopedRealtime();
+
+    private:
+        const char* previous;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedRealtime)
+    };
+
+    // Violations since the last reset, from any thread. The first few are reported in full.
+    int getNumViolations();
+    void resetViolations();
+
+    constexpr bool isEnabled() { return true; }
+#else
+    class ScopedRealtime
+    {
+    public:
+        explicit ScopedRealtime(const char*) {}
+        ~ScopedRealtime() {}
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedRealtime)
+    };
+
+    inline int getNumViolations() { return 0; }
+    inline void resetViolations() {}
+
+    constexpr bool isEnabled() { return false; }
+#endif
+}
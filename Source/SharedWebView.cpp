@@ -0,0 +1,123 @@
+#include "SharedWebView.h"
+#include "WebUIResourceProvider.h"
+#include <utility>
+
+//==============================================================================
+WebViewSession::WebViewSession()
+{
+    auto options = juce::WebBrowserComponent::Options{}
+       #if JUCE_WINDOWS
+        .withBackend(juce::WebBrowserComponent::Options::Backend::webview2)
+        .withWinWebView2Options(
+            juce::WebBrowserComponent::Options::WinWebView2{}
+                .withUserDataFolder(juce::File::getSpecialLocation(juce::File::tempDirectory).getChildFile("Sway"))
+        )
+       #endif
+        // Pooled sessions sit detached between editors; keep the page alive meanwhile
+        .withKeepPageLoadedWhenBrowserIsHidden()
+        .withNativeIntegrationEnabled();
+
+    for (const auto* eventId : { "uiReady", "requestParameters", "parameterChange", "parameterGesture", "getPluginInfo",
+                                 "activateLicense", "deactivateLicense", "getActivationStatus" })
+    {
+        options = options.withEventListener(eventId, [this, id = juce::Identifier(eventId)](const juce::var& data)
+        {
+            handleEvent(id, data);
+        });
+    }
+
+#if HAS_WEB_UI_DATA && ! SWAY_DEV_MODE
+    options = options.withResourceProvider([](const juce::String& url) { return WebUIResourceProvider::getResource(url); });
+#endif
+
+    browser = std::make_unique<juce::WebBrowserComponent>(options);
+
+#if SWAY_DEV_MODE
+    browser->goToURL("http://localhost:5173");
+#elif HAS_WEB_UI_DATA
+    browser->goToURL(juce::WebBrowserComponent::getResourceProviderRoot());
+#endif
+}
+
+WebViewSession::~WebViewSession() = default;
+
+void WebViewSession::onUiReady(std::function<void()> callback)
+{
+    if (uiReady)
+    {
+        if (callback != nullptr)
+            callback();
+        return;
+    }
+
+    uiReadyCallback = std::move(callback);
+}
+
+void WebViewSession::handleEvent(const juce::Identifier& eventId, const juce::var& data)
+{
+    if (eventId == juce::Identifier("uiReady"))
+    {
+        uiReady = true;
+        if (auto callback = std::exchange(uiReadyCallback, nullptr))
+            callback();
+        return;
+    }
+
+    if (eventHandler != nullptr)
+        eventHandler(eventId, data);
+}
+
+//==============================================================================
+JUCE_IMPLEMENT_SINGLETON(WebViewPool)
+
+WebViewPool::WebViewPool()
+{
+   #if HAS_WEB_UI_DATA && ! SWAY_DEV_MODE
+    // Index the embedded assets here rather than inside the first page request
+    WebUIResourceProvider::preload();
+   #endif
+}
+
+WebViewPool::~WebViewPool()
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+    spares.clear();
+    clearSingletonInstance();
+}
+
+std::unique_ptr<WebViewSession> WebViewPool::acquire()
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    if (spares.empty())
+        return std::make_unique<WebViewSession>();
+
+    auto session = std::move(spares.back());
+    spares.pop_back();
+    return session;
+}
+
+void WebViewPool::release(std::unique_ptr<WebViewSession> session)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    if (session == nullptr)
+        return;
+
+   #if SWAY_WEBVIEW_PREWARM
+    session->setEventHandler(nullptr);
+    session->onUiReady(nullptr);
+
+    if (static_cast<int>(spares.size()) < kMaxSpares)
+        spares.push_back(std::move(session));
+   #endif
+}
+
+void WebViewPool::recordOpenLatency(double milliseconds, bool warm)
+{
+    ++openLatency.count;
+    openLatency.lastMs = milliseconds;
+    openLatency.lastWasWarm = warm;
+    openLatency.meanMs += (milliseconds - openLatency.meanMs) / openLatency.count;
+    openLatency.maxMs = juce::jmax(openLatency.maxMs, milliseconds);
+}
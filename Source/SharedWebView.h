@@ -0,0 +1,80 @@
+#pragma once
+
+#include <juce_gui_extra/juce_gui_extra.h>
+#include <functional>
+#include <vector>
+
+// A WebBrowserComponent with the Sway UI loaded. The event listeners are bound
+// at construction, so they forward to whichever editor currently owns the
+// session; parameters travel over those events (see ParameterStream).
+class WebViewSession
+{
+public:
+    using EventHandler = std::function<void(const juce::Identifier& eventId, const juce::var& data)>;
+
+    WebViewSession();
+    ~WebViewSession();
+
+    juce::WebBrowserComponent& getBrowser() { return *browser; }
+
+    // Receives the UI's events (parameters, plugin info, activation) for the current owner
+    void setEventHandler(EventHandler handler) { eventHandler = std::move(handler); }
+
+    // True once the page has loaded and the app reported "uiReady"
+    bool isUiReady() const { return uiReady; }
+    void onUiReady(std::function<void()> callback);
+
+private:
+    void handleEvent(const juce::Identifier& eventId, const juce::var& data);
+
+    std::unique_ptr<juce::WebBrowserComponent> browser;
+
+    EventHandler eventHandler;
+    std::function<void()> uiReadyCallback;
+    bool uiReady = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WebViewSession)
+};
+
+// Process-wide pool of WebView sessions shared by every Sway editor in the host.
+// Created by the first editor, not by the processors, so plugin scans and
+// offline renders never start a browser. Owned by JUCE's DeletedAtShutdown
+// list, which tears it down on the message thread with the GUI. With
+// SWAY_WEBVIEW_PREWARM a closed editor hands its session back as a loaded
+// spare for the next one; without it the browser goes with the editor. All
+// sessions share one WebView user data folder and therefore one browser process.
+class WebViewPool : private juce::DeletedAtShutdown
+{
+public:
+    // Sessions kept loaded while no editor uses them
+    static constexpr int kMaxSpares = 1;
+
+    ~WebViewPool() override;
+
+    JUCE_DECLARE_SINGLETON_SINGLETHREADED(WebViewPool, true)
+
+    // Message thread. A loaded spare if there is one, otherwise a new session.
+    std::unique_ptr<WebViewSession> acquire();
+
+    // Message thread. Keeps the session as a spare or destroys it.
+    void release(std::unique_ptr<WebViewSession> session);
+
+    // Editor-open latency: construction until the loaded UI shows the editor's parameters
+    struct OpenLatency
+    {
+        int count = 0;
+        double lastMs = 0.0, meanMs = 0.0, maxMs = 0.0;
+        bool lastWasWarm = false;
+    };
+
+    void recordOpenLatency(double milliseconds, bool warm);
+    OpenLatency getOpenLatency() const { return openLatency; }
+
+private:
+    WebViewPool();
+
+    std::vector<std::unique_ptr<WebViewSession>> spares;
+    OpenLatency openLatency;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WebViewPool)
+};
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <type_traits>
+#include <vector>
+
+// How a tap reads between samples. Linear is the cheapest and rolls off the
+// top octave; cubic is a 4-point Hermite, flat much further up; allpass is
+// first order with a flat magnitude at every frequency, meant for the
+// flanger's single slowly swept tap (its phase lags briefly whenever the
+// delay crosses a whole sample, which fast multi-voice chorus sweeps expose).
+enum class DelayInterpolation
+{
+    linear = 0,
+    cubic,
+    allpass
+};
+
+// One delay buffer shared by every chorus/flanger/ensemble voice.
+// L/R are stored interleaved, so a tap reads both channels from the same
+// cache line and the input is written once per sample regardless of voice count.
+//
+// Storage is sized in prepare() for the longest delay at the current sample
+// rate and rounded up to a power of two, so wrapping is a mask. Nothing here
+// allocates once prepare() has returned.
+//
+// SampleType is the audio precision. Delay times, increments and gains are
+// control data from ModulationEngine and stay float either way.
+template <typename SampleType>
+class StereoDelayLine
+{
+public:
+    using Vec = juce::dsp::SIMDRegister<float>;
+    static constexpr int kLanes = static_cast<int>(Vec::size());
+    static constexpr size_t kAlignment = Vec::SIMDRegisterSize;
+    static constexpr int kMaxTaps = 8;
+
+    void prepare(double sampleRate, float maxDelayMs)
+    {
+        // +3 frames: the cubic read touches two frames beyond the delay
+        const int maxDelaySamples = static_cast<int>(std::ceil(maxDelayMs * 0.001 * sampleRate)) + 3;
+        size = juce::nextPowerOfTwo(maxDelaySamples);
+        mask = size - 1;
+        data.assign(static_cast<size_t>(size) * 2, SampleType(0));
+        writePos = 0;
+        clearAllpasses();
+    }
+
+    void clear()
+    {
+        std::fill(data.begin(), data.end(), SampleType(0));
+        writePos = 0;
+        clearAllpasses();
+    }
+
+    int getSize() const { return size; }
+
+    // The allpass tier is recursive; call when switching to it so it starts from rest
+    void clearAllpasses()
+    {
+        for (auto& channel : allpassOutput)
+            channel.fill(SampleType(0));
+    }
+
+    void write(SampleType left, SampleType right)
+    {
+        data[static_cast<size_t>(writePos) * 2] = left;
+        data[static_cast<size_t>(writePos) * 2 + 1] = right;
+    }
+
+    // Mono: only channel 0 is written, and only channel 0 may be read
+    void write(SampleType left)
+    {
+        data[static_cast<size_t>(writePos) * 2] = left;
+    }
+
+    // Sums one interpolated tap per voice for one channel, processing
+    // SIMD-register-width voices at a time. delays, increments and gains must be
+    // SIMD-aligned and padded to a multiple of kLanes; unused lanes carry a gain
+    // of 0. Each delay (in samples, >= 1, at most kMaxTaps voices) is advanced
+    // by its increment.
+    template <DelayInterpolation Interpolation>
+    SampleType readVoices(int channel, float* delays, const float* increments,
+                          const float* gains, int numVoices)
+    {
+        // Cubic reads one frame either side of the linear pair
+        constexpr int numPoints = Interpolation == DelayInterpolation::cubic ? 4 : 2;
+        constexpr int firstPoint = Interpolation == DelayInterpolation::cubic ? -1 : 0;
+
+        auto sum = Vec::expand(0.0f);
+        auto wideSum = SampleType(0);
+        auto* previous = allpassOutput[static_cast<size_t>(channel)].data();
+
+        for (int v = 0; v < numVoices; v += kLanes)
+        {
+            const auto delay = Vec::fromRawArray(delays + v);
+
+            // The allpass takes its fraction from [0.5, 1.5), which keeps its
+            // coefficient well away from the pole at -1
+            const auto whole = Interpolation == DelayInterpolation::allpass ? Vec::truncate(delay - 0.5f)
+                                                                            : Vec::truncate(delay);
+            const auto frac = delay - whole;
+
+            alignas(kAlignment) float wholeLanes[kLanes];
+            alignas(kAlignment) SampleType taps[numPoints][kLanes];
+            whole.copyToRawArray(wholeLanes);
+
+            // Gather: the only per-lane scalar work left
+            for (int lane = 0; lane < kLanes; ++lane)
+            {
+                const int idx = (writePos - static_cast<int>(wholeLanes[lane])) & mask;
+                for (int p = 0; p < numPoints; ++p)
+                    taps[p][lane] = data[static_cast<size_t>((idx - firstPoint - p) & mask) * 2 + static_cast<size_t>(channel)];
+            }
+
+            if constexpr (std::is_same_v<SampleType, float> && Interpolation != DelayInterpolation::allpass)
+            {
+                Vec s[numPoints];
+                for (int p = 0; p < numPoints; ++p)
+                    s[p] = Vec::fromRawArray(taps[p]);
+
+                if constexpr (Interpolation == DelayInterpolation::cubic)
+                    sum += hermite(s[0], s[1], s[2], s[3], frac) * Vec::fromRawArray(gains + v);
+                else
+                    sum += (s[0] + (s[1] - s[0]) * frac) * Vec::fromRawArray(gains + v);
+            }
+            else
+            {
+                // Scalar per lane: the allpass recursion carries state and needs
+                // a division, and double interpolates at full precision (only
+                // the fractional position is float)
+                alignas(kAlignment) float fracLanes[kLanes];
+                frac.copyToRawArray(fracLanes);
+
+                for (int lane = 0; lane < kLanes; ++lane)
+                {
+                    const SampleType t = fracLanes[lane];
+                    SampleType y;
+
+                    if constexpr (Interpolation == DelayInterpolation::allpass)
+                    {
+                        const SampleType eta = (SampleType(1) - t) / (SampleType(1) + t);
+                        y = taps[1][lane] + eta * (taps[0][lane] - previous[v + lane]);
+                        previous[v + lane] = y;
+                    }
+                    else if constexpr (Interpolation == DelayInterpolation::cubic)
+                    {
+                        y = hermite(taps[0][lane], taps[1][lane], taps[2][lane], taps[3][lane], t);
+                    }
+                    else
+                    {
+                        y = taps[0][lane] + (taps[1][lane] - taps[0][lane]) * t;
+                    }
+
+                    wideSum += y * gains[v + lane];
+                }
+            }
+
+            (delay + Vec::fromRawArray(increments + v)).copyToRawArray(delays + v);
+        }
+
+        if constexpr (std::is_same_v<SampleType, float> && Interpolation != DelayInterpolation::allpass)
+            return sum.sum();
+        else
+            return static_cast<SampleType>(wideSum);
+    }
+
+    void advance()
+    {
+        writePos = (writePos + 1) & mask;
+    }
+
+private:
+    // 4-point, 3rd-order Hermite (Catmull-Rom) between x0 and x1, t in [0, 1).
+    // Works on a register of lanes or a single sample alike.
+    template <typename Value>
+    static Value hermite(Value xm1, Value x0, Value x1, Value x2, Value t)
+    {
+        using Scalar = std::conditional_t<std::is_same_v<Value, Vec>, float, Value>;
+
+        const auto c1 = (x1 - xm1) * Scalar(0.5);
+        const auto c2 = xm1 - x0 * Scalar(2.5) + x1 * Scalar(2) - x2 * Scalar(0.5);
+        const auto c3 = (x2 - xm1) * Scalar(0.5) + (x0 - x1) * Scalar(1.5);
+        return ((c3 * t + c2) * t + c1) * t + x0;
+    }
+
+    std::vector<SampleType> data;
+    int size = 0;
+    int mask = 0;
+    int writePos = 0;
+
+    // Last output of each voice's allpass, per channel
+    std::array<std::array<SampleType, kMaxTaps>, 2> allpassOutput {};
+};
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+#include "ModulationEngine.h"
+
+// Modulation state at one point in time, as drawn by the WebView visualizer.
+// Plain data so a push or pop is a struct copy.
+struct VisualizerSnapshot
+{
+    float rms = 0.0f;           // input RMS of the block, averaged over channels
+    float lfoPhase = 0.0f;      // master LFO phase, 0-1
+    float lfoValue = 0.0f;      // left LFO output, -1 to 1
+    float stereoPhase[2] {};    // per-channel LFO output mapped to 0-1
+    float modDepth[2] {};       // per-channel |LFO| x depth, 0-1
+    std::array<float, ModulationEngine::kMaxVoices> voicePhases {};  // per-voice LFO phase, 0-1
+    int numVoices = 1;
+    int mode = 0;
+    bool bypassed = false;
+};
+
+// Wait-free single-producer/single-consumer queue of visualizer snapshots.
+// The audio thread pushes, the editor's timer pops. Neither side locks or
+// allocates; when the consumer falls behind (or no editor is open) new
+// snapshots are dropped rather than overwriting ones being read.
+class VisualizerFifo
+{
+public:
+    static constexpr int kCapacity = 32;
+
+    // Audio thread. Returns false if the queue was full.
+    bool push(const VisualizerSnapshot& snapshot)
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite(1, start1, size1, start2, size2);
+
+        if (size1 + size2 == 0)
+        {
+            numDropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        slots[static_cast<size_t>(size1 > 0 ? start1 : start2)] = snapshot;
+        fifo.finishedWrite(1);
+        return true;
+    }
+
+    // Message thread. Returns false if nothing is queued.
+    bool pop(VisualizerSnapshot& snapshot)
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(1, start1, size1, start2, size2);
+
+        if (size1 + size2 == 0)
+            return false;
+
+        snapshot = slots[static_cast<size_t>(size1 > 0 ? start1 : start2)];
+        fifo.finishedRead(1);
+        return true;
+    }
+
+    // Message thread. Drops everything queued, e.g. the backlog built up
+    // while no editor was draining.
+    void discardPending()
+    {
+        VisualizerSnapshot unused;
+        while (pop(unused)) {}
+    }
+
+    juce::uint32 getNumDropped() const { return numDropped.load(std::memory_order_relaxed); }
+
+private:
+    // One slot is kept free by AbstractFifo to tell full from empty
+    juce::AbstractFifo fifo { kCapacity + 1 };
+    std::array<VisualizerSnapshot, kCapacity + 1> slots {};
+    std::atomic<juce::uint32> numDropped { 0 };
+};
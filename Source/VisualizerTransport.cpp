@@ -0,0 +1,79 @@
+#include "VisualizerTransport.h"
+
+VisualizerTransport::VisualizerTransport()
+{
+    packed.reserve(static_cast<size_t>(kHeaderSize + VisualizerFifo::kCapacity * kFrameStride));
+}
+
+bool VisualizerTransport::isSame(const VisualizerSnapshot& a, const VisualizerSnapshot& b)
+{
+    // Well below a pixel at the visualizer's size
+    constexpr float tolerance = 1.0e-4f;
+    auto near = [](float x, float y) { return std::abs(x - y) <= tolerance; };
+
+    if (a.mode != b.mode || a.bypassed != b.bypassed || a.numVoices != b.numVoices)
+        return false;
+
+    if (! near(a.rms, b.rms) || ! near(a.lfoPhase, b.lfoPhase) || ! near(a.lfoValue, b.lfoValue))
+        return false;
+
+    for (int ch = 0; ch < 2; ++ch)
+        if (! near(a.stereoPhase[ch], b.stereoPhase[ch]) || ! near(a.modDepth[ch], b.modDepth[ch]))
+            return false;
+
+    for (int v = 0; v < a.numVoices; ++v)
+        if (! near(a.voicePhases[static_cast<size_t>(v)], b.voicePhases[static_cast<size_t>(v)]))
+            return false;
+
+    return true;
+}
+
+void VisualizerTransport::add(const VisualizerSnapshot& snapshot)
+{
+    if (hasSent && isSame(snapshot, lastSent))
+        return;
+
+    if (numPending == VisualizerFifo::kCapacity)
+        return;
+
+    if (numPending == 0)
+    {
+        packed.clear();
+        packed.push_back(static_cast<float>(kLayoutVersion));
+        packed.push_back(static_cast<float>(kFrameStride));
+    }
+
+    packed.push_back(snapshot.rms);
+    packed.push_back(snapshot.lfoPhase);
+    packed.push_back(snapshot.lfoValue);
+    packed.push_back(snapshot.stereoPhase[0]);
+    packed.push_back(snapshot.stereoPhase[1]);
+    packed.push_back(snapshot.modDepth[0]);
+    packed.push_back(snapshot.modDepth[1]);
+    packed.push_back(static_cast<float>(snapshot.mode));
+    packed.push_back(snapshot.bypassed ? 1.0f : 0.0f);
+    packed.push_back(static_cast<float>(snapshot.numVoices));
+    packed.insert(packed.end(), snapshot.voicePhases.begin(), snapshot.voicePhases.end());
+
+    ++numPending;
+    lastSent = snapshot;
+    hasSent = true;
+}
+
+juce::String VisualizerTransport::takePayload()
+{
+    // Every supported target is little-endian, which is what Float32Array reads
+    const auto payload = juce::Base64::toBase64(packed.data(), packed.size() * sizeof(float));
+    packed.clear();
+    numPending = 0;
+    return payload;
+}
+
+int VisualizerTransport::getNextRateHz(bool visible, bool sentThisTick)
+{
+    if (! visible)
+        return kHiddenRateHz;
+
+    ticksWithoutChange = sentThisTick ? 0 : ticksWithoutChange + 1;
+    return ticksWithoutChange < kIdleTicks ? kActiveRateHz : kIdleRateHz;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <vector>
+#include "VisualizerFifo.h"
+
+// Packs visualizer snapshots into the binary frames the web UI decodes
+// (readFloat32Frames in web-ui/src/lib/juce-bridge.ts).
+//
+// A payload is base64 of little-endian Float32 values: a two-value header
+// { kLayoutVersion, kFrameStride } followed by one kFrameStride-sized frame
+// per snapshot, oldest first. Frame layout:
+//   0 rms, 1 lfoPhase, 2 lfoValue, 3 stereoPhaseL, 4 stereoPhaseR,
+//   5 modDepthL, 6 modDepthR, 7 mode, 8 bypassed, 9 numVoices,
+//   10.. voicePhases[kMaxVoices]
+// Snapshots that match the last one sent are skipped, so a stopped LFO or a
+// bypassed plugin sends nothing.
+class VisualizerTransport
+{
+public:
+    static constexpr int kLayoutVersion = 1;
+    static constexpr int kHeaderSize = 2;
+    static constexpr int kFrameStride = 10 + ModulationEngine::kMaxVoices;
+
+    // Timer rates: while values change, after kIdleTicks unchanged ticks, and while hidden
+    static constexpr int kActiveRateHz = 60;
+    static constexpr int kIdleRateHz = 15;
+    static constexpr int kHiddenRateHz = 4;
+    static constexpr int kIdleTicks = 30;
+
+    VisualizerTransport();
+
+    // Queues the snapshot for the next payload unless nothing visible changed
+    void add(const VisualizerSnapshot& snapshot);
+
+    bool hasPendingFrames() const { return numPending > 0; }
+
+    // Encodes the queued frames and clears the queue
+    juce::String takePayload();
+
+    // Called once per timer tick; returns the rate the timer should run at next
+    int getNextRateHz(bool visible, bool sentThisTick);
+
+private:
+    static bool isSame(const VisualizerSnapshot& a, const VisualizerSnapshot& b);
+
+    // The FIFO never holds more than its capacity, so neither does a batch
+    std::vector<float> packed;
+    int numPending = 0;
+
+    VisualizerSnapshot lastSent;
+    bool hasSent = false;
+    int ticksWithoutChange = 0;
+};
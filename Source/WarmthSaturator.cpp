@@ -0,0 +1,186 @@
+#include "WarmthSaturator.h"
+#include <algorithm>
+
+namespace
+{
+    // The fast approximations for float; the double path keeps its precision
+    inline float sampleTanh(float x) { return FastMath::tanh(x); }
+    inline double sampleTanh(double x) { return std::tanh(x); }
+
+    inline float sampleLogCosh(float x) { return FastMath::logCosh(x); }
+    inline double sampleLogCosh(double x)
+    {
+        // log(cosh(x)) without overflow: |x| + log1p(exp(-2|x|)) - log(2)
+        constexpr double ln2 = 0.69314718055994530942;
+        const double a = std::abs(x);
+        return a + std::log1p(std::exp(-2.0 * a)) - ln2;
+    }
+
+    // Steps in drive * x below which the ADAA quotient is replaced by the
+    // midpoint tanh. The quotient divides the antiderivative's rounding error
+    // by the step, so float needs a much larger one; the midpoint's own error
+    // there is about step^2 / 24.
+    inline float adaaMinStep(float) { return 1.0e-3f; }
+    inline double adaaMinStep(double) { return 1.0e-5; }
+}
+
+template <typename SampleType>
+void WarmthSaturator<SampleType>::prepare(double sampleRate, int maxBlockSize)
+{
+    juce::ignoreUnused(sampleRate);
+
+    latency[0] = 0;
+
+    for (size_t q = 1; q < oversampling.size(); ++q)
+    {
+        oversampling[q] = std::make_unique<juce::dsp::Oversampling<SampleType>>(
+            2, q, juce::dsp::Oversampling<SampleType>::filterHalfBandPolyphaseIIR, true, true);
+        oversampling[q]->initProcessing(static_cast<size_t>(maxBlockSize));
+        latency[q] = juce::roundToInt(oversampling[q]->getLatencyInSamples());
+    }
+
+    const int maxLatency = *std::max_element(latency.begin(), latency.end());
+    const int dryLength = juce::nextPowerOfTwo(maxLatency + 1);
+    dryMask = dryLength - 1;
+    dryBuffer.assign(static_cast<size_t>(dryLength) * 2, SampleType(0));
+
+    reset();
+}
+
+template <typename SampleType>
+void WarmthSaturator<SampleType>::reset()
+{
+    adaa = {};
+    adaaDrive = 1.0f;
+    adaaPrimed = false;
+
+    for (auto& os : oversampling)
+        if (os != nullptr)
+            os->reset();
+
+    std::fill(dryBuffer.begin(), dryBuffer.end(), SampleType(0));
+    dryWritePos = 0;
+}
+
+template <typename SampleType>
+void WarmthSaturator<SampleType>::setQuality(Quality newQuality)
+{
+    if (newQuality == quality)
+        return;
+
+    quality = newQuality;
+    reset();
+}
+
+template <typename SampleType>
+void WarmthSaturator<SampleType>::processEco(SampleType* samples, int numSamples, AdaaState& state, SampleType drive) const
+{
+    // Works on u = drive x: the slope of log(cosh(u)) over u is tanh(u), scaled back by 1 / drive
+    const SampleType invDrive = SampleType(1) / drive;
+    const SampleType minStep = adaaMinStep(drive);
+
+    // Locals, since samples could alias the state as far as the compiler knows
+    SampleType x1 = state.x1;
+    SampleType f1 = state.f1;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const SampleType x = samples[i];
+        const SampleType u = x * drive;
+        const SampleType u1 = x1 * drive;
+        const SampleType f = sampleLogCosh(u);
+        const SampleType du = u - u1;
+
+        const SampleType y = std::abs(du) > minStep ? (f - f1) / du
+                                                    : sampleTanh(SampleType(0.5) * (u + u1));
+
+        x1 = x;
+        f1 = f;
+        samples[i] = y * invDrive;
+    }
+
+    state.x1 = x1;
+    state.f1 = f1;
+}
+
+template <typename SampleType>
+void WarmthSaturator<SampleType>::process(SampleType* left, SampleType* right, int numSamples, float drive, bool active)
+{
+    if (quality == Quality::eco)
+    {
+        jassert(active);
+
+        // Starting from the first sample makes its step zero, so the output
+        // begins at the plain tanh instead of jumping from a stale history
+        if (! adaaPrimed)
+        {
+            adaa[0].x1 = left[0];
+            if (right != nullptr)
+                adaa[1].x1 = right[0];
+            adaaDrive = 0.0f;
+            adaaPrimed = true;
+        }
+
+        // The cached antiderivatives depend on the drive, which can change per block
+        if (drive != adaaDrive)
+        {
+            adaaDrive = drive;
+            for (auto& state : adaa)
+                state.f1 = sampleLogCosh(state.x1 * static_cast<SampleType>(adaaDrive));
+        }
+
+        processEco(left, numSamples, adaa[0], static_cast<SampleType>(adaaDrive));
+        if (right != nullptr)
+            processEco(right, numSamples, adaa[1], static_cast<SampleType>(adaaDrive));
+        return;
+    }
+
+    auto& os = *oversampling[static_cast<size_t>(quality)];
+
+    SampleType* channels[] = { left, right };
+    juce::dsp::AudioBlock<SampleType> block(channels, right != nullptr ? 2 : 1, static_cast<size_t>(numSamples));
+    auto upsampled = os.processSamplesUp(block);
+
+    if (active)
+    {
+        const auto gain = static_cast<SampleType>(drive);
+        const auto invDrive = SampleType(1) / gain;
+
+        for (size_t ch = 0; ch < upsampled.getNumChannels(); ++ch)
+        {
+            SampleType* samples = upsampled.getChannelPointer(ch);
+            for (size_t i = 0; i < upsampled.getNumSamples(); ++i)
+                samples[i] = sampleTanh(samples[i] * gain) * invDrive;
+        }
+    }
+
+    os.processSamplesDown(block);
+}
+
+template <typename SampleType>
+void WarmthSaturator<SampleType>::delayDry(SampleType* left, SampleType* right, int numSamples)
+{
+    const int delay = getLatencySamples();
+    if (delay == 0)
+        return;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const auto writeIndex = static_cast<size_t>(dryWritePos) * 2;
+        const auto readIndex = static_cast<size_t>((dryWritePos - delay) & dryMask) * 2;
+
+        dryBuffer[writeIndex] = left[i];
+        left[i] = dryBuffer[readIndex];
+
+        if (right != nullptr)
+        {
+            dryBuffer[writeIndex + 1] = right[i];
+            right[i] = dryBuffer[readIndex + 1];
+        }
+
+        dryWritePos = (dryWritePos + 1) & dryMask;
+    }
+}
+
+template class WarmthSaturator<float>;
+template class WarmthSaturator<double>;
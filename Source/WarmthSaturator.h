@@ -0,0 +1,75 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <memory>
+#include <vector>
+#include "FastMath.h"
+
+// Warmth saturation for the wet signal, tanh(x * drive) / drive.
+//
+// Eco runs at the base rate with first-order antiderivative antialiasing
+// (ADAA): the output is the slope of the antiderivative log(cosh(drive x)) / drive^2
+// between consecutive inputs, which suppresses most of the aliasing without
+// oversampling and adds no latency (only a half-sample shift on the wet path).
+// HQ runs plain tanh inside a 2x or 4x polyphase IIR oversampler. Its integer
+// latency is reported to the host, and delayDry() delays the dry path to match.
+//
+// SampleType is the audio precision; float and double are instantiated in the
+// .cpp. The double build uses libm tanh and log-cosh where the float one uses
+// FastMath, so Eco costs about one FastMath::tanh more than plain tanh.
+enum class WarmthQuality { eco = 0, hq2x, hq4x };
+
+template <typename SampleType>
+class WarmthSaturator
+{
+public:
+    using Quality = WarmthQuality;
+
+    // maxBlockSize is the longest run passed to process()
+    void prepare(double sampleRate, int maxBlockSize);
+    void reset();
+
+    // Switching quality resets the oversampler and dry delay; call from the audio thread
+    void setQuality(Quality newQuality);
+    Quality getQuality() const { return quality; }
+
+    // Latency of the current quality in samples at the base rate
+    int getLatencySamples() const { return latency[static_cast<size_t>(quality)]; }
+
+    // Eco only: the next process() seeds the ADAA history from its own first
+    // sample. Call when the stage re-enters the path after skipping blocks.
+    void forgetHistory() { adaaPrimed = false; }
+
+    // Saturates both channels in place; right may be nullptr for mono. In HQ mode
+    // the oversampler runs even when active is false, so the wet path keeps a
+    // constant latency. Eco is taken out of the path instead and needs active.
+    void process(SampleType* left, SampleType* right, int numSamples, float drive, bool active);
+
+    // Delays a dry run by getLatencySamples(), in place. right may be nullptr.
+    void delayDry(SampleType* left, SampleType* right, int numSamples);
+
+private:
+    struct AdaaState
+    {
+        SampleType x1 = 0;    // previous input
+        SampleType f1 = 0;    // log(cosh(drive x1)) for the current drive
+    };
+
+    void processEco(SampleType* samples, int numSamples, AdaaState& state, SampleType drive) const;
+
+    Quality quality = Quality::eco;
+
+    std::array<AdaaState, 2> adaa;
+    float adaaDrive = 1.0f;     // drive the cached antiderivatives were computed for
+    bool adaaPrimed = false;    // adaa holds the previous sample of this stream
+
+    // Indexed by Quality; [0] (eco) is unused
+    std::array<std::unique_ptr<juce::dsp::Oversampling<SampleType>>, 3> oversampling;
+    std::array<int, 3> latency {};
+
+    // Dry compensation, interleaved L/R, power-of-two length
+    std::vector<SampleType> dryBuffer;
+    int dryMask = 0;
+    int dryWritePos = 0;
+};
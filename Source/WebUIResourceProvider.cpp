@@ -0,0 +1,106 @@
+#include "WebUIResourceProvider.h"
+#include <string>
+#include <unordered_map>
+
+#if HAS_WEB_UI_DATA
+#include "WebUIData.h"
+#endif
+
+namespace
+{
+    struct Asset
+    {
+        const std::byte* data = nullptr;    // into WebUIData
+        size_t size = 0;
+        const char* mimeType = nullptr;
+    };
+
+    using AssetTable = std::unordered_map<std::string, Asset>;
+
+   #if HAS_WEB_UI_DATA
+    AssetTable buildAssetTable()
+    {
+        AssetTable table;
+
+        for (int i = 0; i < WebUIData::namedResourceListSize; ++i)
+        {
+            int size = 0;
+            const char* data = WebUIData::getNamedResource(WebUIData::namedResourceList[i], size);
+            const juce::String fileName(WebUIData::originalFilenames[i]);
+
+            if (data == nullptr)
+                continue;
+
+            table[fileName.toStdString()] = { reinterpret_cast<const std::byte*>(data), static_cast<size_t>(size),
+                                              WebUIResourceProvider::getMimeType(fileName) };
+        }
+
+        return table;
+    }
+   #else
+    AssetTable buildAssetTable() { return {}; }
+   #endif
+
+    // Built once, then read-only, so concurrent requests need no lock
+    const AssetTable& getAssetTable()
+    {
+        static const AssetTable table = buildAssetTable();
+        return table;
+    }
+}
+
+namespace WebUIResourceProvider
+{
+    void preload()
+    {
+        getAssetTable();
+    }
+
+    std::optional<juce::WebBrowserComponent::Resource> getResource(const juce::String& url)
+    {
+        const auto& table = getAssetTable();
+
+        auto fileName = url.upToFirstOccurrenceOf("?", false, false)
+                           .upToFirstOccurrenceOf("#", false, false)
+                           .fromLastOccurrenceOf("/", false, false);
+        if (fileName.isEmpty())
+            fileName = "index.html";
+
+        const auto it = table.find(fileName.toStdString());
+        if (it == table.end())
+            return std::nullopt;
+
+        const auto& asset = it->second;
+        return juce::WebBrowserComponent::Resource { { asset.data, asset.data + asset.size }, asset.mimeType };
+    }
+
+    const char* getMimeType(const juce::String& fileName)
+    {
+        static const std::unordered_map<std::string, const char*> types {
+            { "html",  "text/html" },
+            { "htm",   "text/html" },
+            { "js",    "text/javascript" },
+            { "mjs",   "text/javascript" },
+            { "css",   "text/css" },
+            { "json",  "application/json" },
+            { "map",   "application/json" },
+            { "txt",   "text/plain" },
+            { "svg",   "image/svg+xml" },
+            { "png",   "image/png" },
+            { "jpg",   "image/jpeg" },
+            { "jpeg",  "image/jpeg" },
+            { "gif",   "image/gif" },
+            { "webp",  "image/webp" },
+            { "ico",   "image/x-icon" },
+            { "woff",  "font/woff" },
+            { "woff2", "font/woff2" },
+            { "ttf",   "font/ttf" },
+            { "otf",   "font/otf" },
+            { "wasm",  "application/wasm" }
+        };
+
+        const auto extension = fileName.fromLastOccurrenceOf(".", false, false).toLowerCase().toStdString();
+        const auto it = types.find(extension);
+        return it != types.end() ? it->second : "application/octet-stream";
+    }
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <juce_gui_extra/juce_gui_extra.h>
+#include <optional>
+
+// Serves the Web UI embedded as WebUIData to WebBrowserComponent.
+//
+// Requests are looked up by file name in a table shared by every editor in the
+// process. Each entry points into the embedded data, so a request costs a hash
+// lookup and the one copy WebBrowserComponent::Resource needs: it owns its
+// bytes as a vector and carries no headers, so neither a view of BinaryData
+// nor a Content-Encoding for precompressed assets can be handed to the browser.
+namespace WebUIResourceProvider
+{
+    // Builds the asset table now instead of on the first request. Safe to call repeatedly.
+    void preload();
+
+    // For WebBrowserComponent::Options::withResourceProvider; url is the request path
+    std::optional<juce::WebBrowserComponent::Resource> getResource(const juce::String& url);
+
+    // MIME type from the file extension, "application/octet-stream" if unknown
+    const char* getMimeType(const juce::String& fileName);
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <array>
+#include <random>
+
+// The processBlock SWAY shipped before the optimization work, kept verbatim as
+// a second null-test reference (sway_bench --verify, null/baseline/...). Where
+// SwayReferenceProcessor models what the plugin is meant to output now, this
+// pins down the behaviour users already had, for the settings whose output was
+// not changed on purpose: stereo, sine LFO, warmth off, linear taps.
+//
+// Only the surroundings are adapted: parameters come from another processor's
+// APVTS, the visualizer stores are gone, and the LFO shapes are file-local.
+// The per-sample body is the original, std::pow, std::tan and all.
+class SwayBaselineProcessor
+{
+public:
+    // Reads the same raw parameter values as the processor that owns `parameters`
+    explicit SwayBaselineProcessor(juce::AudioProcessorValueTreeState& parameters);
+
+    void prepare(double sampleRate);
+
+    // Mono or stereo, in place
+    void process(juce::AudioBuffer<float>& buffer);
+
+private:
+    float getRandomLFO(float phase, int channel);
+
+    juce::AudioProcessorValueTreeState& apvts;
+
+    // Delay lines for chorus/flanger (per voice, stereo)
+    static constexpr int kMaxVoices = 8;
+    static constexpr int kMaxDelaySize = 4096;  // ~90ms at 44.1kHz
+    std::array<std::array<float, kMaxDelaySize>, kMaxVoices * 2> delayLines {};
+    int writePos = 0;
+
+    // Allpass filters for phaser (12 stages max, stereo)
+    struct AllpassStage {
+        float z1 = 0.0f;
+        float process(float input, float coeff) {
+            float output = -input * coeff + z1;
+            z1 = output * coeff + input;
+            return output;
+        }
+    };
+    std::array<std::array<AllpassStage, 12>, 2> phaserStages {};
+
+    // LFO state
+    float lfoPhase[2] = { 0.0f, 0.0f };
+    std::mt19937 rng;
+    float randomLfoValue[2] = { 0.0f, 0.0f };
+    float randomLfoTarget[2] = { 0.0f, 0.0f };
+    float lastRandomPhase = 0.0f;
+
+    // Feedback state
+    float feedbackSample[2] = { 0.0f, 0.0f };
+
+    // Parameter smoothing
+    juce::SmoothedValue<float> rateSmoothed;
+    juce::SmoothedValue<float> depthSmoothed;
+    juce::SmoothedValue<float> feedbackSmoothed;
+    juce::SmoothedValue<float> mixSmoothed;
+
+    double currentSampleRate = 44100.0;
+};
@@ -0,0 +1,271 @@
+#include "ReferenceProcessor.h"
+#include "ParameterIDs.h"
+#include "LfoWavetable.h"
+
+SwayReferenceProcessor::SwayReferenceProcessor(juce::AudioProcessorValueTreeState& parameters)
+    : apvts(parameters)
+{
+}
+
+void SwayReferenceProcessor::prepare(double newSampleRate, juce::uint32 seed)
+{
+    sampleRate = newSampleRate;
+
+    // 30 ms (chorus maximum) plus the interpolation neighbours
+    const auto size = static_cast<size_t>(std::ceil(30.0 * 0.001 * sampleRate)) + 3;
+    for (auto& channel : delayBuffer)
+        channel.assign(size, 0.0f);
+    writePos = 0;
+
+    for (auto& channel : allpassState)
+        std::fill(std::begin(channel), std::end(channel), 0.0f);
+
+    for (auto& channel : tapAllpassState)
+        std::fill(std::begin(channel), std::end(channel), 0.0);
+
+    masterPhase = 0.0;
+    lfoPhase[0] = lfoPhase[1] = 0.0f;
+    random.prepare(sampleRate);
+    random.reset(seed);
+    randomSmoothing = random.getSmoothing(1);
+    primed = false;
+
+    feedbackSample[0] = feedbackSample[1] = 0.0f;
+    saturatorInput[0] = saturatorInput[1] = 0.0;
+
+    rateSmoothed.reset(sampleRate, 0.05);
+    depthSmoothed.reset(sampleRate, 0.02);
+    feedbackSmoothed.reset(sampleRate, 0.02);
+    mixSmoothed.reset(sampleRate, 0.02);
+
+    rateSmoothed.setCurrentAndTargetValue(apvts.getRawParameterValue(ParameterIDs::rate)->load());
+    depthSmoothed.setCurrentAndTargetValue(apvts.getRawParameterValue(ParameterIDs::depth)->load() / 100.0f);
+    feedbackSmoothed.setCurrentAndTargetValue(apvts.getRawParameterValue(ParameterIDs::feedback)->load() / 100.0f);
+    mixSmoothed.setCurrentAndTargetValue(apvts.getRawParameterValue(ParameterIDs::mix)->load() / 100.0f);
+}
+
+float SwayReferenceProcessor::saturate(float x, int channel, double drive, bool active)
+{
+    const double x0 = saturatorInput[channel];
+    saturatorInput[channel] = x;
+
+    if (! active)
+        return x;
+
+    // First-order ADAA of tanh(drive x) / drive; antiderivative log(cosh(drive x)) / drive^2
+    auto antiderivative = [drive](double v) { return std::log(std::cosh(v * drive)) / (drive * drive); };
+
+    const double dx = x - x0;
+    if (std::abs(dx) > 1.0e-5)
+        return static_cast<float>((antiderivative(x) - antiderivative(x0)) / dx);
+
+    return static_cast<float>(std::tanh(0.5 * (x + x0) * drive) / drive);
+}
+
+void SwayReferenceProcessor::process(juce::AudioBuffer<float>& buffer)
+{
+    const int numChannels = buffer.getNumChannels();
+    const int numSamples = buffer.getNumSamples();
+    const float sr = static_cast<float>(sampleRate);
+
+    const int modeVal = static_cast<int>(apvts.getRawParameterValue(ParameterIDs::mode)->load());
+    const int shapeVal = static_cast<int>(apvts.getRawParameterValue(ParameterIDs::shape)->load());
+    const float stereoPhaseVal = apvts.getRawParameterValue(ParameterIDs::stereoPhase)->load() / 100.0f * 0.5f;
+    const int voicesVal = static_cast<int>(apvts.getRawParameterValue(ParameterIDs::voices)->load());
+    const float spreadVal = apvts.getRawParameterValue(ParameterIDs::spread)->load() / 100.0f;
+    const float warmthVal = apvts.getRawParameterValue(ParameterIDs::warmth)->load() / 100.0f;
+    int interpolationVal = static_cast<int>(apvts.getRawParameterValue(ParameterIDs::interpolation)->load());
+    const int stagesVal = static_cast<int>(apvts.getRawParameterValue(ParameterIDs::stages)->load());
+    const float colorVal = apvts.getRawParameterValue(ParameterIDs::color)->load() / 100.0f;
+    const float widthVal = apvts.getRawParameterValue(ParameterIDs::width)->load() / 100.0f;
+    const bool bypassVal = apvts.getRawParameterValue(ParameterIDs::bypass)->load() > 0.5f;
+
+    rateSmoothed.setTargetValue(apvts.getRawParameterValue(ParameterIDs::rate)->load());
+    depthSmoothed.setTargetValue(apvts.getRawParameterValue(ParameterIDs::depth)->load() / 100.0f);
+    feedbackSmoothed.setTargetValue(apvts.getRawParameterValue(ParameterIDs::feedback)->load() / 100.0f);
+    mixSmoothed.setTargetValue(apvts.getRawParameterValue(ParameterIDs::mix)->load() / 100.0f);
+
+    if (bypassVal) return;
+
+    // The right LFO starts at its stereo offset rather than at zero for one sample
+    if (! primed)
+    {
+        lfoPhase[1] = lfoPhase[0] + stereoPhaseVal;
+        if (lfoPhase[1] >= 1.0f) lfoPhase[1] -= 1.0f;
+        primed = true;
+    }
+
+    float minDelay = 1.0f, maxDelay = 10.0f;
+    switch (modeVal)
+    {
+        case 0:  minDelay = 7.0f;  maxDelay = 30.0f; break;
+        case 1:  minDelay = 0.1f;  maxDelay = 10.0f; break;
+        case 3:  minDelay = 5.0f;  maxDelay = 25.0f; break;
+        default: break;
+    }
+
+    // Same rules as the plugin: the nearest tap is at least a sample back, and
+    // the allpass tier is the flanger's alone
+    const float minDelaySamples = std::max(minDelay * sr / 1000.0f, 1.0f);
+    const float maxDelaySamples = std::max(maxDelay * sr / 1000.0f, minDelaySamples);
+    if (interpolationVal == 2 && modeVal != 1)
+        interpolationVal = 1;
+
+    const double drive = 1.0 + warmthVal * 3.0f;
+    const int delaySize = static_cast<int>(delayBuffer[0].size());
+
+    const float* inputL = buffer.getReadPointer(0);
+    const float* inputR = numChannels > 1 ? buffer.getReadPointer(1) : inputL;
+    float* outputL = buffer.getWritePointer(0);
+    float* outputR = numChannels > 1 ? buffer.getWritePointer(1) : nullptr;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float curRate = rateSmoothed.getNextValue();
+        const float curDepth = depthSmoothed.getNextValue();
+        const float curFeedback = feedbackSmoothed.getNextValue();
+        const float curMix = mixSmoothed.getNextValue();
+
+        const float lfoFreq = 0.01f * std::pow(2000.0f, curRate / 100.0f);
+        const float lfoInc = lfoFreq / sr;
+
+        float lfo[2];
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            const float phase = lfoPhase[ch];
+            switch (shapeVal)
+            {
+                case 1:  lfo[ch] = static_cast<float>(LfoWavetable::evaluate(LfoWavetable::triangle, phase)); break;
+                case 2:  lfo[ch] = static_cast<float>(LfoWavetable::evaluate(LfoWavetable::square, phase)); break;
+                case 3:  random.advance(ch, phase, randomSmoothing); lfo[ch] = random.getValue(ch); break;
+                default: lfo[ch] = std::sin(phase * juce::MathConstants<float>::twoPi); break;
+            }
+        }
+
+        masterPhase += lfoInc;
+        if (masterPhase >= 1.0) masterPhase -= 1.0;
+        lfoPhase[0] = static_cast<float>(masterPhase);
+        lfoPhase[1] = lfoPhase[0] + stereoPhaseVal;
+        if (lfoPhase[1] >= 1.0f) lfoPhase[1] -= 1.0f;
+
+        const float input[2] = { inputL[i], inputR[i] };
+        float wet[2] = { 0.0f, 0.0f };
+
+        if (modeVal == 2)
+        {
+            const float minFreq = 200.0f;
+            const float maxFreq = 4000.0f + colorVal * 4000.0f;
+
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                float x = input[ch] + feedbackSample[ch] * curFeedback * 0.7f;
+
+                for (int s = 0; s < stagesVal; ++s)
+                {
+                    const float stagePhase = static_cast<float>(s) / static_cast<float>(stagesVal);
+                    const float mod = lfo[ch] * std::sin(stagePhase * juce::MathConstants<float>::pi);
+                    const float freq = minFreq + (maxFreq - minFreq) * (0.5f + mod * curDepth * 0.5f);
+                    const float t = std::tan(juce::MathConstants<float>::pi * freq / sr);
+                    const float coeff = (t - 1.0f) / (t + 1.0f);
+
+                    const float y = -x * coeff + allpassState[ch][s];
+                    allpassState[ch][s] = y * coeff + x;
+                    x = y;
+                }
+
+                wet[ch] = x;
+            }
+        }
+        else
+        {
+            for (int ch = 0; ch < 2; ++ch)
+                delayBuffer[ch][static_cast<size_t>(writePos)] = input[ch] + feedbackSample[ch] * curFeedback;
+
+            for (int v = 0; v < voicesVal; ++v)
+            {
+                const float voiceOffset = static_cast<float>(v) / static_cast<float>(voicesVal);
+
+                for (int ch = 0; ch < 2; ++ch)
+                {
+                    const float voiceLfo = std::sin(std::fmod(lfoPhase[ch] + voiceOffset * spreadVal, 1.0f)
+                                                    * juce::MathConstants<float>::twoPi);
+                    const float delaySamples = minDelaySamples
+                                             + (maxDelaySamples - minDelaySamples) * (0.5f + voiceLfo * curDepth * 0.5f);
+
+                    if (interpolationVal == 0)
+                    {
+                        float readPos = static_cast<float>(writePos) - delaySamples;
+                        while (readPos < 0.0f) readPos += static_cast<float>(delaySize);
+
+                        const int idx = static_cast<int>(readPos) % delaySize;
+                        const int idx1 = (idx + 1) % delaySize;
+                        const float frac = readPos - std::floor(readPos);
+
+                        wet[ch] += delayBuffer[ch][static_cast<size_t>(idx)] * (1.0f - frac)
+                                 + delayBuffer[ch][static_cast<size_t>(idx1)] * frac;
+                        continue;
+                    }
+
+                    // Sample `delay` whole samples before the one just written
+                    auto tap = [&](int delay) -> double
+                    {
+                        return delayBuffer[ch][static_cast<size_t>(((writePos - delay) % delaySize + delaySize) % delaySize)];
+                    };
+
+                    const double d = delaySamples;
+
+                    if (interpolationVal == 1)
+                    {
+                        // 4-point Hermite (Catmull-Rom)
+                        const int whole = static_cast<int>(std::floor(d));
+                        const double t = d - whole;
+                        const double xm1 = tap(whole - 1), x0 = tap(whole), x1 = tap(whole + 1), x2 = tap(whole + 2);
+                        const double c1 = 0.5 * (x1 - xm1);
+                        const double c2 = xm1 - 2.5 * x0 + 2.0 * x1 - 0.5 * x2;
+                        const double c3 = 0.5 * (x2 - xm1) + 1.5 * (x0 - x1);
+                        wet[ch] += static_cast<float>(((c3 * t + c2) * t + c1) * t + x0);
+                    }
+                    else
+                    {
+                        // First-order allpass with its fraction in [0.5, 1.5)
+                        const int whole = static_cast<int>(std::floor(d - 0.5));
+                        const double t = d - whole;
+                        const double eta = (1.0 - t) / (1.0 + t);
+                        auto& previous = tapAllpassState[ch][v];
+                        previous = tap(whole + 1) + eta * (tap(whole) - previous);
+                        wet[ch] += static_cast<float>(previous);
+                    }
+                }
+            }
+
+            for (auto& w : wet)
+                w /= static_cast<float>(voicesVal);
+        }
+
+        feedbackSample[0] = wet[0];
+        feedbackSample[1] = wet[1];
+
+        for (int ch = 0; ch < 2; ++ch)
+            wet[ch] = saturate(wet[ch], ch, drive, warmthVal > 0.01f);
+
+        if (numChannels == 2)
+        {
+            if (std::abs(widthVal - 1.0f) > 0.01f)
+            {
+                const float mid = (wet[0] + wet[1]) * 0.5f;
+                const float side = (wet[0] - wet[1]) * 0.5f * widthVal;
+                wet[0] = mid + side;
+                wet[1] = mid - side;
+            }
+
+            outputL[i] = input[0] * (1.0f - curMix) + wet[0] * curMix;
+            outputR[i] = input[1] * (1.0f - curMix) + wet[1] * curMix;
+        }
+        else
+        {
+            outputL[i] = input[0] * (1.0f - curMix) + wet[0] * curMix;
+        }
+
+        writePos = (writePos + 1) % delaySize;
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <vector>
+#include "RandomModulator.h"
+
+// Per-sample scalar rendering of SwayAudioProcessor's algorithm, kept as the
+// ground truth the optimized kernels are null-tested against (sway_bench --verify).
+//
+// This is the original processBlock, updated only where the plugin's intended
+// output changed: the delay buffer is sized per sample rate, warmth uses the
+// Eco ADAA saturator, the LFO phase accumulates in double, the right LFO starts
+// at its stereo offset, a mono bus outputs the left wet channel, the random
+// LFO is RandomModulator stepped per sample (per-channel streams and wrap
+// detection, glide in seconds), triangle and square are the softened shapes
+// of LfoWavetable::evaluate(), and the cubic and allpass tap interpolations
+// are modelled in double. It evaluates everything at audio rate with libm,
+// one sample at a time. Keep it simple rather than fast.
+class SwayReferenceProcessor
+{
+public:
+    // Reads the same raw parameter values as the processor that owns `parameters`
+    explicit SwayReferenceProcessor(juce::AudioProcessorValueTreeState& parameters);
+
+    // seed must match SwayAudioProcessor::setRandomSeed() for Random-shape renders to agree
+    void prepare(double sampleRate, juce::uint32 seed);
+
+    // Mono or stereo, in place. Only the Eco warmth quality is modelled.
+    void process(juce::AudioBuffer<float>& buffer);
+
+private:
+    float saturate(float x, int channel, double drive, bool active);
+
+    juce::AudioProcessorValueTreeState& apvts;
+    double sampleRate = 44100.0;
+
+    // One stereo delay buffer; every voice reads it with its own modulated tap
+    std::vector<float> delayBuffer[2];
+    int writePos = 0;
+
+    float allpassState[2][12] {};
+    double tapAllpassState[2][8] {};    // per voice, for the allpass interpolation
+
+    double masterPhase = 0.0;
+    float lfoPhase[2] = { 0.0f, 0.0f };
+    bool primed = false;
+    RandomModulator random;
+    float randomSmoothing = 0.0f;   // glide step for one sample
+
+    float feedbackSample[2] = { 0.0f, 0.0f };
+    double saturatorInput[2] = { 0.0, 0.0 };
+
+    juce::SmoothedValue<float> rateSmoothed;
+    juce::SmoothedValue<float> depthSmoothed;
+    juce::SmoothedValue<float> feedbackSmoothed;
+    juce::SmoothedValue<float> mixSmoothed;
+};
@@ -0,0 +1,1427 @@
+/*
+  ==============================================================================
+    sway_bench - DSP benchmarks for SWAY
+
+    Usage:
+      sway_bench [options]
+
+      --full                 cartesian mode x shape x voices/stages x block x rate
+      --filter <text>        only run configurations whose name contains text
+      --seconds <s>          audio rendered per measurement (default: 1)
+      --repeats <n>          measurements per configuration, best kept (default: 3)
+      --out <file>           write JSON results to file (default: stdout)
+      --baseline <file>      compare against a previous JSON result
+      --threshold <percent>  allowed ns/sample regression (default: 10)
+      --verify               run the accuracy checks instead of benchmarks
+                             (FastMath, LFO table and phaser coefficient
+                             bounds, null tests against the
+                             per-sample reference renderer and the
+                             original processBlock, surround
+                             layout checks, double against float
+                             precision and idle mode; --filter applies)
+
+    Every configuration drives SwayAudioProcessor::processBlock on stereo
+    noise and reports ns per sample frame and the real-time factor; names
+    ending in /f64 run the double-precision processBlock natively, and /idle
+    feeds digital silence once the processor has gone idle. The
+    cascade/ entries time PhaserCascade against a runtime stage loop, and
+    the warmth/ entries time the saturation stage alone: off, the old
+    per-sample std::tanh, Eco and HQ 2x/4x.
+    With --baseline the exit code is 1 if any configuration got slower than
+    the threshold allows.
+  ==============================================================================
+*/
+
+#include "ToolUtils.h"
+#include "ReferenceProcessor.h"
+#include "BaselineProcessor.h"
+#include "FastMath.h"
+#include "LfoWavetable.h"
+#include "RealtimeSafety.h"
+
+#include <iostream>
+#include <limits>
+#include <map>
+#include <set>
+
+namespace
+{
+    const char* const modeNames[] = { "chorus", "flanger", "phaser", "ensemble" };
+    const char* const shapeNames[] = { "sine", "triangle", "square", "random" };
+    const char* const interpolationNames[] = { "linear", "cubic", "allpass" };
+
+    struct Options
+    {
+        bool full = false;
+        bool verify = false;
+        juce::String filter;
+        double seconds = 1.0;
+        int repeats = 3;
+        juce::File outputFile;
+        juce::File baselineFile;
+        double thresholdPercent = 10.0;
+    };
+
+    struct Config
+    {
+        int mode = 0;
+        int shape = 0;
+        int voices = 3;
+        int stages = 6;
+        int blockSize = 512;
+        double sampleRate = 48000.0;
+        bool doublePrecision = false;
+        bool silentInput = false;   // digital silence after the tail has died: the idle path
+        int interpolation = 0;      // delay tap tier; the phaser has no taps
+
+        // Float, noise-fed, linear names carry no suffix, so older baselines still match
+        juce::String getName() const
+        {
+            return juce::String(modeNames[mode]) + "/" + shapeNames[shape]
+                 + "/v" + juce::String(voices) + "/s" + juce::String(stages)
+                 + "/b" + juce::String(blockSize) + "/" + juce::String(juce::roundToInt(sampleRate))
+                 + (doublePrecision ? "/f64" : "") + (silentInput ? "/idle" : "")
+                 + (interpolation != 0 ? juce::String("/") + interpolationNames[interpolation] : juce::String());
+        }
+    };
+
+    struct Result
+    {
+        juce::String name;
+        juce::var details;
+        double nsPerSample = 0.0;
+        double realtimeFactor = 0.0;
+    };
+
+    juce::Result parseOptions(int argc, char* argv[], Options& options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const juce::String arg(argv[i]);
+            const bool hasValue = i + 1 < argc;
+
+            auto takeValue = [&]() { return juce::String(argv[++i]); };
+            auto takeFile = [&]() { return juce::File::getCurrentWorkingDirectory().getChildFile(takeValue()); };
+
+            if (arg == "--full")                         options.full = true;
+            else if (arg == "--verify")                  options.verify = true;
+            else if (arg == "--filter" && hasValue)      options.filter = takeValue();
+            else if (arg == "--seconds" && hasValue)     options.seconds = takeValue().getDoubleValue();
+            else if (arg == "--repeats" && hasValue)     options.repeats = takeValue().getIntValue();
+            else if (arg == "--out" && hasValue)         options.outputFile = takeFile();
+            else if (arg == "--baseline" && hasValue)    options.baselineFile = takeFile();
+            else if (arg == "--threshold" && hasValue)   options.thresholdPercent = takeValue().getDoubleValue();
+            else                                         return juce::Result::fail("unknown option " + arg);
+        }
+
+        if (options.seconds <= 0.0 || options.repeats < 1)
+            return juce::Result::fail("--seconds and --repeats must be positive");
+
+        return juce::Result::ok();
+    }
+
+    //==============================================================================
+    std::vector<Config> buildMatrix(bool full)
+    {
+        const int blockSizes[] = { 1, 16, 32, 64, 256, 512, 1024, 4096 };
+        const double sampleRates[] = { 44100.0, 48000.0, 96000.0, 192000.0 };
+
+        std::vector<Config> configs;
+        std::set<juce::String> names;
+
+        auto add = [&](const Config& config)
+        {
+            if (names.insert(config.getName()).second)
+                configs.push_back(config);
+        };
+
+        if (full)
+        {
+            for (int mode = 0; mode < 4; ++mode)
+                for (int shape = 0; shape < 4; ++shape)
+                    for (int count = mode == 2 ? 2 : 1; count <= (mode == 2 ? 12 : 8); ++count)
+                        for (int blockSize : blockSizes)
+                            for (double sampleRate : sampleRates)
+                                for (bool doublePrecision : { false, true })
+                                    for (int interpolation = 0; interpolation < (mode == 2 ? 1 : mode == 1 ? 3 : 2); ++interpolation)
+                                    {
+                                        Config config;
+                                        config.mode = mode;
+                                        config.shape = shape;
+                                        (mode == 2 ? config.stages : config.voices) = count;
+                                        config.blockSize = blockSize;
+                                        config.sampleRate = sampleRate;
+                                        config.doublePrecision = doublePrecision;
+                                        config.interpolation = interpolation;
+                                        add(config);
+                                    }
+
+            return configs;
+        }
+
+        // Each axis swept on its own around the defaults
+        for (int mode = 0; mode < 4; ++mode)
+            for (int shape = 0; shape < 4; ++shape)
+            {
+                Config config;
+                config.mode = mode;
+                config.shape = shape;
+                add(config);
+            }
+
+        for (int mode : { 0, 3 })
+            for (int voices = 1; voices <= 8; ++voices)
+            {
+                Config config;
+                config.mode = mode;
+                config.voices = voices;
+                add(config);
+            }
+
+        // Each tap tier at the default and the largest voice count; allpass is the flanger's
+        for (int mode : { 0, 1, 3 })
+            for (int interpolation = 1; interpolation < (mode == 1 ? 3 : 2); ++interpolation)
+                for (int voices : { 3, 8 })
+                    for (bool doublePrecision : { false, true })
+                    {
+                        Config config;
+                        config.mode = mode;
+                        config.voices = voices;
+                        config.doublePrecision = doublePrecision;
+                        config.interpolation = interpolation;
+                        add(config);
+                    }
+
+        for (int stages = 2; stages <= 12; ++stages)
+        {
+            Config config;
+            config.mode = 2;
+            config.stages = stages;
+            add(config);
+        }
+
+        for (int mode = 0; mode < 4; ++mode)
+        {
+            for (int blockSize : blockSizes)
+                for (bool doublePrecision : { false, true })
+                {
+                    Config config;
+                    config.mode = mode;
+                    config.blockSize = blockSize;
+                    config.doublePrecision = doublePrecision;
+                    add(config);
+                }
+
+            for (double sampleRate : sampleRates)
+            {
+                Config config;
+                config.mode = mode;
+                config.sampleRate = sampleRate;
+                add(config);
+            }
+
+            Config idle;
+            idle.mode = mode;
+            idle.silentInput = true;
+            add(idle);
+        }
+
+        return configs;
+    }
+
+    // Deterministic stereo noise the measurements read from
+    juce::AudioBuffer<float> makeNoise()
+    {
+        juce::AudioBuffer<float> noise(2, 8192);
+        juce::Random random(1234);
+
+        for (int ch = 0; ch < noise.getNumChannels(); ++ch)
+            for (int i = 0; i < noise.getNumSamples(); ++i)
+                noise.setSample(ch, i, (random.nextFloat() * 2.0f - 1.0f) * 0.25f);
+
+        return noise;
+    }
+
+    // Runs fn(numFrames) over `seconds` of audio in block-sized calls; returns the best ns per frame
+    template <typename Fn>
+    double measure(const Options& options, double sampleRate, int blockSize, Fn&& fn)
+    {
+        const auto totalFrames = static_cast<juce::int64>(options.seconds * sampleRate);
+
+        // Warm caches, branch predictors and smoothers first
+        for (juce::int64 pos = 0; pos < totalFrames / 10; pos += blockSize)
+            fn(blockSize);
+
+        double best = std::numeric_limits<double>::max();
+
+        for (int r = 0; r < options.repeats; ++r)
+        {
+            const auto start = juce::Time::getHighResolutionTicks();
+
+            for (juce::int64 pos = 0; pos < totalFrames; pos += blockSize)
+                fn(static_cast<int>(juce::jmin<juce::int64>(blockSize, totalFrames - pos)));
+
+            const double elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+            best = juce::jmin(best, elapsed * 1.0e9 / static_cast<double>(totalFrames));
+        }
+
+        return best;
+    }
+
+    template <typename SampleType>
+    double measureProcessor(SwayAudioProcessor& processor, const Config& config, const Options& options,
+                            const juce::AudioBuffer<float>& floatNoise)
+    {
+        juce::AudioBuffer<SampleType> noise;
+        noise.makeCopyOf(floatNoise);
+        if (config.silentInput)
+            noise.clear();
+
+        juce::AudioBuffer<SampleType> buffer(2, config.blockSize);
+        juce::MidiBuffer midi;
+        int readPos = 0;
+
+        // Let the tail die away first, so the measurement sees the idle path
+        for (int pos = 0; config.silentInput && pos < static_cast<int>(4.0 * config.sampleRate) && ! processor.isIdle();
+             pos += config.blockSize)
+        {
+            buffer.clear();
+            processor.processBlock(buffer, midi);
+        }
+
+        return measure(options, config.sampleRate, config.blockSize, [&](int numSamples)
+        {
+            buffer.setSize(2, numSamples, false, false, true);
+
+            // The processor works in place, so refill from the noise table every block
+            const int first = juce::jmin(numSamples, noise.getNumSamples() - readPos);
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                buffer.copyFrom(ch, 0, noise, ch, readPos, first);
+                if (first < numSamples)
+                    buffer.copyFrom(ch, first, noise, ch, 0, numSamples - first);
+            }
+            readPos = (readPos + numSamples) % noise.getNumSamples();
+
+            processor.processBlock(buffer, midi);
+        });
+    }
+
+    Result runConfig(const Config& config, const Options& options, const juce::AudioBuffer<float>& noise)
+    {
+        SwayAudioProcessor processor;
+        SwayTools::setChannelLayout(processor, 2);
+
+        SwayTools::applyParameter(processor, juce::String(ParameterIDs::mode) + "=" + juce::String(config.mode));
+        SwayTools::applyParameter(processor, juce::String(ParameterIDs::shape) + "=" + juce::String(config.shape));
+        SwayTools::applyParameter(processor, juce::String(ParameterIDs::voices) + "=" + juce::String(config.voices));
+        SwayTools::applyParameter(processor, juce::String(ParameterIDs::stages) + "=" + juce::String(config.stages));
+        SwayTools::applyParameter(processor, juce::String(ParameterIDs::interpolation) + "=" + juce::String(config.interpolation));
+
+        processor.setProcessingPrecision(config.doublePrecision ? juce::AudioProcessor::doublePrecision
+                                                                : juce::AudioProcessor::singlePrecision);
+        processor.setRateAndBufferSizeDetails(config.sampleRate, config.blockSize);
+        processor.prepareToPlay(config.sampleRate, config.blockSize);
+
+        const double ns = config.doublePrecision ? measureProcessor<double>(processor, config, options, noise)
+                                                 : measureProcessor<float>(processor, config, options, noise);
+
+        processor.releaseResources();
+
+        auto* details = new juce::DynamicObject();
+        details->setProperty("mode", modeNames[config.mode]);
+        details->setProperty("shape", shapeNames[config.shape]);
+        details->setProperty("voices", config.voices);
+        details->setProperty("stages", config.stages);
+        details->setProperty("blockSize", config.blockSize);
+        details->setProperty("sampleRate", config.sampleRate);
+        details->setProperty("precision", config.doublePrecision ? "double" : "float");
+        details->setProperty("input", config.silentInput ? "silence" : "noise");
+        details->setProperty("interpolation", interpolationNames[config.interpolation]);
+
+        Result result;
+        result.name = config.getName();
+        result.details = juce::var(details);
+        result.nsPerSample = ns;
+        result.realtimeFactor = 1.0e9 / (ns * config.sampleRate);
+        return result;
+    }
+
+    //==============================================================================
+    // The allpass cascade as a runtime loop over the stage count, as processBlock
+    // ran it before PhaserCascade; kept here as the comparison point.
+    struct RuntimeLoopCascade
+    {
+        float state[2][PhaserCascade<float>::kMaxStages] {};
+
+        void process(const PhaserCascade<float>::Block& block, int numStages)
+        {
+            float coeff[2][PhaserCascade<float>::kMaxStages];
+            std::copy(block.coeffL, block.coeffL + numStages, coeff[0]);
+            std::copy(block.coeffR, block.coeffR + numStages, coeff[1]);
+
+            const float* input[] = { block.inputL, block.inputR };
+            const float* increments[] = { block.coeffIncL, block.coeffIncR };
+            float* wet[] = { block.wetL, block.wetR };
+            float feedback = block.feedback;
+
+            for (int i = 0; i < block.numSamples; ++i)
+            {
+                feedback += block.feedbackInc;
+
+                for (int ch = 0; ch < 2; ++ch)
+                {
+                    float x = input[ch][i] + block.feedbackSample[ch] * (feedback * 0.7f);
+
+                    for (int s = 0; s < numStages; ++s)
+                    {
+                        const float y = state[ch][s] - x * coeff[ch][s];
+                        state[ch][s] = y * coeff[ch][s] + x;
+                        coeff[ch][s] += increments[ch][s];
+                        x = y;
+                    }
+
+                    wet[ch][i] = x;
+                    block.feedbackSample[ch] = x;
+                }
+            }
+        }
+    };
+
+    juce::String getCascadeName(int numStages, bool templated)
+    {
+        return juce::String("cascade/") + (templated ? "template" : "loop") + "/s" + juce::String(numStages);
+    }
+
+    Result runCascade(int numStages, bool templated, const Options& options, const juce::AudioBuffer<float>& noise)
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr int interval = ModulationEngine::kDefaultControlInterval;
+
+        float coeff[PhaserCascade<float>::kMaxStages], coeffInc[PhaserCascade<float>::kMaxStages];
+        for (int s = 0; s < PhaserCascade<float>::kMaxStages; ++s)
+        {
+            coeff[s] = -0.6f + 0.05f * static_cast<float>(s);
+            coeffInc[s] = 1.0e-6f;
+        }
+
+        float wetL[interval], wetR[interval];
+        float feedbackSample[2] = { 0.0f, 0.0f };
+
+        PhaserCascade<float> cascade;
+        cascade.reset();
+        const auto processTemplated = PhaserCascade<float>::getProcessFunction(numStages);
+        RuntimeLoopCascade loop;
+        int readPos = 0;
+
+        const double ns = measure(options, sampleRate, interval, [&](int numSamples)
+        {
+            PhaserCascade<float>::Block block;
+            block.inputL = noise.getReadPointer(0, readPos);
+            block.inputR = noise.getReadPointer(1, readPos);
+            block.wetL = wetL;
+            block.wetR = wetR;
+            block.numSamples = numSamples;
+            block.coeffL = block.coeffR = coeff;
+            block.coeffIncL = block.coeffIncR = coeffInc;
+            block.feedback = 0.5f;
+            block.feedbackInc = 0.0f;
+            block.feedbackSample = feedbackSample;
+            readPos = (readPos + interval) % (noise.getNumSamples() - interval);
+
+            if (templated)
+                (cascade.*processTemplated)(block);
+            else
+                loop.process(block, numStages);
+        });
+
+        auto* details = new juce::DynamicObject();
+        details->setProperty("kernel", templated ? "template" : "loop");
+        details->setProperty("stages", numStages);
+        details->setProperty("blockSize", interval);
+        details->setProperty("sampleRate", sampleRate);
+
+        Result result;
+        result.name = getCascadeName(numStages, templated);
+        result.details = juce::var(details);
+        result.nsPerSample = ns;
+        result.realtimeFactor = 1.0e9 / (ns * sampleRate);
+        return result;
+    }
+
+    // The warmth stage alone on the wet signal of one control interval, stereo,
+    // at 40 % warmth: skipped, the per-sample std::tanh that processBlock used
+    // before the Eco/HQ stage, and the three qualities of WarmthSaturator.
+    const char* const warmthNames[] = { "off", "tanh", "eco", "hq2x", "hq4x" };
+    volatile float warmthSink = 0.0f;    // keeps the unused output from being optimized away
+
+    Result runWarmth(int variant, const Options& options, const juce::AudioBuffer<float>& noise)
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr int interval = ModulationEngine::kDefaultControlInterval;
+        constexpr float drive = 1.0f + 0.4f * 3.0f;
+
+        WarmthSaturator<float> saturator;
+        saturator.prepare(sampleRate, interval);
+        if (variant > 2)
+            saturator.setQuality(static_cast<WarmthQuality>(variant - 2));
+
+        float wetL[interval], wetR[interval];
+        int readPos = 0;
+
+        const double ns = measure(options, sampleRate, interval, [&](int numSamples)
+        {
+            std::copy_n(noise.getReadPointer(0, readPos), numSamples, wetL);
+            std::copy_n(noise.getReadPointer(1, readPos), numSamples, wetR);
+            readPos = (readPos + interval) % (noise.getNumSamples() - interval);
+
+            if (variant == 1)
+            {
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    wetL[i] = std::tanh(wetL[i] * drive) / drive;
+                    wetR[i] = std::tanh(wetR[i] * drive) / drive;
+                }
+            }
+            else if (variant > 1)
+            {
+                saturator.process(wetL, wetR, numSamples, drive, true);
+            }
+
+            warmthSink = wetL[numSamples - 1] + wetR[numSamples - 1];
+        });
+
+        auto* details = new juce::DynamicObject();
+        details->setProperty("warmth", warmthNames[variant]);
+        details->setProperty("blockSize", interval);
+        details->setProperty("sampleRate", sampleRate);
+
+        Result result;
+        result.name = juce::String("warmth/") + warmthNames[variant];
+        result.details = juce::var(details);
+        result.nsPerSample = ns;
+        result.realtimeFactor = 1.0e9 / (ns * sampleRate);
+        return result;
+    }
+
+    //==============================================================================
+    // Accuracy checks; each prints one line and returns false on failure
+    bool checkError(const char* name, double maxError, double bound)
+    {
+        const bool ok = maxError <= bound;
+        std::cout << (ok ? "PASS  " : "FAIL  ") << juce::String(name).paddedRight(' ', 28)
+                  << "max error " << juce::String(maxError, 9) << " (bound " << juce::String(bound, 9) << ")\n";
+        return ok;
+    }
+
+    bool verifyFastMath(const juce::String& filter)
+    {
+        const auto wanted = [&filter](const char* name) { return juce::String(name).contains(filter); };
+        bool ok = true;
+
+        if (wanted("FastMath::exp2 (relative)"))
+        {
+            double maxError = 0.0;
+            for (double p = -126.0; p < 127.0; p += 1.0e-3)
+            {
+                const auto x = static_cast<float>(p);
+                maxError = juce::jmax(maxError, std::abs(FastMath::exp2(x) / std::exp2(static_cast<double>(x)) - 1.0));
+            }
+            ok = checkError("FastMath::exp2 (relative)", maxError, FastMath::kExp2MaxRelError) && ok;
+        }
+
+        // Wet signal times the largest warmth drive, with headroom for feedback
+        if (wanted("FastMath::tanh"))
+        {
+            double maxError = 0.0;
+            for (double p = -12.0; p < 12.0; p += 1.0e-5)
+            {
+                const auto x = static_cast<float>(p);
+                maxError = juce::jmax(maxError, std::abs(FastMath::tanh(x) - std::tanh(static_cast<double>(x))));
+            }
+            ok = checkError("FastMath::tanh", maxError, FastMath::kTanhMaxError) && ok;
+        }
+
+        // Eco's antiderivative over the same drive range and beyond
+        if (wanted("FastMath::logCosh"))
+        {
+            double maxError = 0.0;
+            for (double p = -40.0; p < 40.0; p += 1.0e-5)
+            {
+                const auto x = static_cast<float>(p);
+                const double a = std::abs(static_cast<double>(x));
+                const double want = a + std::log1p(std::exp(-2.0 * a)) - 0.69314718055994530942;
+                maxError = juce::jmax(maxError, std::abs(FastMath::logCosh(x) - want));
+            }
+            ok = checkError("FastMath::logCosh", maxError, FastMath::kLogCoshMaxError) && ok;
+        }
+
+        return ok;
+    }
+
+    // The tabulated allpass coefficient against the exact one over the whole
+    // sweep range. Linear interpolation error is h^2/8 times the curvature,
+    // which is largest at the lowest sample rate.
+    bool verifyPhaserCoefficients(const juce::String& filter)
+    {
+        bool ok = true;
+
+        for (double sampleRate : { 44100.0, 48000.0, 96000.0, 192000.0 })
+        {
+            const auto name = "PhaserCoefficients/" + juce::String(juce::roundToInt(sampleRate));
+            if (! name.contains(filter))
+                continue;
+
+            PhaserCoefficientGenerator generator;
+            generator.prepare(sampleRate);
+            double maxError = 0.0;
+
+            for (double freq = 0.0; freq <= PhaserCoefficientGenerator::kMaxFreq; freq += 0.37)
+            {
+                const double t = std::tan(juce::MathConstants<double>::pi * freq / sampleRate);
+                const double want = (t - 1.0) / (t + 1.0);
+                maxError = juce::jmax(maxError, std::abs(generator.getCoefficient(static_cast<float>(freq)) - want));
+            }
+
+            ok = checkError(name.toRawUTF8(), maxError, 1.0e-6) && ok;
+        }
+
+        return ok;
+    }
+
+    // The interpolated LFO tables against the shapes they sample, over phases
+    // that fall between table entries
+    bool verifyWavetables(const juce::String& filter)
+    {
+        const char* const names[] = { "LfoWavetable::sine", "LfoWavetable::triangle", "LfoWavetable::square" };
+
+        // Linear interpolation error is h^2/8 times the curvature, plus float
+        // rounding of the entries; the square's glide is the sharpest bend
+        const double bounds[] = { 4.0e-7, 3.0e-6, 4.0e-5 };
+        bool ok = true;
+
+        for (int shape = 0; shape < LfoWavetable::kNumShapes; ++shape)
+        {
+            if (! juce::String(names[shape]).contains(filter))
+                continue;
+
+            const auto& table = LfoWavetable::get(shape);
+            double maxError = 0.0;
+
+            for (juce::uint64 phase = 12345; phase < (juce::uint64(1) << 32); phase += 99991)
+            {
+                const auto p = static_cast<LfoWavetable::Phase>(phase);
+                const double want = LfoWavetable::evaluate(shape, static_cast<double>(p) / 4294967296.0);
+                maxError = juce::jmax(maxError, std::abs(table.read(p) - want));
+            }
+
+            ok = checkError(names[shape], maxError, bounds[shape]) && ok;
+        }
+
+        return ok;
+    }
+
+    struct NullTest
+    {
+        double errorDb = 0.0;   // error energy relative to the reference output
+        double maxError = 0.0;
+    };
+
+    // Renders two seconds of a sine plus noise through the processor and the
+    // per-sample reference (or the pre-optimization baseline, with warmth off)
+    // with identical settings and seed, in block sizes that do not line up with
+    // the control interval, and measures the difference.
+    NullTest renderAgainstReference(int numChannels, int mode, int shape, int controlInterval, int interpolation = 0,
+                                    bool againstBaseline = false, int depth = 80)
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr juce::uint32 seed = 12345;
+        const int blockSizes[] = { 256, 17, 1, 511, 64 };
+
+        SwayAudioProcessor processor;
+        SwayTools::setChannelLayout(processor, numChannels);
+
+        const juce::String settings[] = { "mode=" + juce::String(mode), "shape=" + juce::String(shape),
+                                          "rate=70", "depth=" + juce::String(depth), "feedback=50",
+                                          againstBaseline ? "warmth=0" : "warmth=40",
+                                          "warmthQuality=0", "width=150", "voices=4",
+                                          "interpolation=" + juce::String(interpolation) };
+        for (const auto& assignment : settings)
+            SwayTools::applyParameter(processor, assignment);
+
+        processor.setRandomSeed(seed);
+        processor.setControlInterval(controlInterval);
+        processor.setRateAndBufferSizeDetails(sampleRate, 512);
+        processor.prepareToPlay(sampleRate, 512);
+
+        SwayReferenceProcessor reference(processor.getAPVTS());
+        reference.prepare(sampleRate, seed);
+
+        // Holds 256 KB of delay lines inline
+        auto baseline = std::make_unique<SwayBaselineProcessor>(processor.getAPVTS());
+        baseline->prepare(sampleRate);
+
+        juce::AudioBuffer<float> optimized, expected;
+        juce::MidiBuffer midi;
+        juce::Random random(7);
+        double errorEnergy = 0.0, referenceEnergy = 0.0;
+        NullTest result;
+
+        for (int pos = 0, block = 0; pos < static_cast<int>(2.0 * sampleRate); ++block)
+        {
+            const int numSamples = blockSizes[block % juce::numElementsInArray(blockSizes)];
+            optimized.setSize(numChannels, numSamples, false, false, true);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const auto tone = 0.25f * std::sin(juce::MathConstants<float>::twoPi * 220.0f
+                                                   * static_cast<float>(pos + i) / static_cast<float>(sampleRate));
+                for (int ch = 0; ch < numChannels; ++ch)
+                    optimized.setSample(ch, i, tone + 0.1f * (random.nextFloat() * 2.0f - 1.0f));
+            }
+
+            expected.makeCopyOf(optimized);
+            processor.processBlock(optimized, midi);
+            if (againstBaseline)
+                baseline->process(expected);
+            else
+                reference.process(expected);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    const double want = expected.getSample(ch, i);
+                    const double diff = optimized.getSample(ch, i) - want;
+                    errorEnergy += diff * diff;
+                    referenceEnergy += want * want;
+                    result.maxError = juce::jmax(result.maxError, std::abs(diff));
+                }
+
+            pos += numSamples;
+        }
+
+        processor.releaseResources();
+        result.errorDb = 10.0 * std::log10(errorEnergy / referenceEnergy + 1.0e-30);
+        return result;
+    }
+
+    // Null-test bounds: the worst error measured over mono and stereo, plus 3 dB.
+    // With a control interval of 1 the ramps collapse to per-sample evaluation
+    // and only float rounding and FastMath remain. At the default interval the
+    // linear ramps are part of the result: smooth shapes stay close (the
+    // square's glide included), but a random target is drawn up to one interval
+    // after its phase wraps, which the random phaser shows. The allpass tier
+    // jumps its coefficient whenever a tap crosses a whole sample, and float and
+    // double delays cross a sample apart now and then, each time leaving a short
+    // transient; with the delay held still it nulls below -110 dB.
+    double getReferenceBound(int controlInterval, int mode, int shape, int interpolation)
+    {
+        const bool perSample = controlInterval == 1;
+
+        if (interpolation == 2)
+            return perSample ? -58.0 : -51.0;                   // measured -61.3 / -53.9
+
+        if (mode == 2)
+        {
+            switch (shape)
+            {
+                case 0:  return -101.0;                         // measured -104.0 / -104.0
+                case 1:  return -92.0;                          // measured -95.3 / -95.3
+                case 2:  return perSample ? -101.0 : -99.0;     // measured -103.9 / -102.2
+                default: return perSample ? -92.0 : -72.0;      // measured -95.7 / -74.9
+            }
+        }
+
+        // Every shape renders the same delay-mode taps; cubic is within 0.5 dB of linear
+        switch (mode)
+        {
+            case 0:  return perSample ? -92.0 : -79.0;          // measured -94.9 / -81.7
+            case 1:  return perSample ? -97.0 : -85.0;          // measured -100.1 / -88.3
+            default: return perSample ? -92.0 : -80.0;          // measured -95.5 / -82.8
+        }
+    }
+
+    // Golden-render equivalence of the optimized kernels for every mode, shape,
+    // bus width and tap tier
+    bool verifyAgainstReference(const juce::String& filter)
+    {
+        bool ok = true;
+
+        for (int controlInterval : { 1, ModulationEngine::kDefaultControlInterval })
+            for (int numChannels = 1; numChannels <= 2; ++numChannels)
+                for (int mode = 0; mode < 4; ++mode)
+                    for (int shape = 0; shape < 4; ++shape)
+                        for (int interpolation = 0; interpolation < 3; ++interpolation)
+                        {
+                            // The tap tiers only change the delay modes' reads, which no LFO shape
+                            // touches, and only the flanger has the allpass tier
+                            if (interpolation != 0 && (mode == 2 || shape != 0))
+                                continue;
+                            if (interpolation == 2 && mode != 1)
+                                continue;
+
+                            const auto name = juce::String("null/") + (numChannels == 1 ? "mono/" : "stereo/")
+                                            + modeNames[mode] + "/" + shapeNames[shape] + "/i" + juce::String(controlInterval)
+                                            + (interpolation != 0 ? juce::String("/") + interpolationNames[interpolation] : juce::String());
+                            if (! name.contains(filter))
+                                continue;
+
+                            const double bound = getReferenceBound(controlInterval, mode, shape, interpolation);
+
+                            const auto test = renderAgainstReference(numChannels, mode, shape, controlInterval, interpolation);
+                            const bool passed = test.errorDb <= bound;
+                            ok = ok && passed;
+
+                            std::cout << (passed ? "PASS  " : "FAIL  ") << name.paddedRight(' ', 36)
+                                      << juce::String(test.errorDb, 1) << " dB (bound " << juce::String(bound, 1)
+                                      << " dB)  max error " << juce::String(test.maxError, 7) << "\n";
+                        }
+
+        return ok;
+    }
+
+    // Existing behaviour: the plugin against the processBlock it replaced, for
+    // the settings whose output was kept (stereo, sine, warmth off, linear taps).
+    // With the LFO still (depth 0) every other path is compared: delay reads,
+    // feedback, the voice sum, the phaser cascade, width and mix. Chorus and
+    // ensemble then null exactly, bounded loosely enough for a SIMD voice sum
+    // that adds in another order; the flanger's taps sit between samples and
+    // round differently. Swept, the baseline's float phase accumulator drifts
+    // from the exact integer phase by a growing fraction of a cycle, so those
+    // bounds only catch a changed delay range, rate mapping or LFO shape.
+    bool verifyAgainstBaseline(const juce::String& filter)
+    {
+        struct Bounds { double still, swept; };
+        static constexpr Bounds bounds[] = {
+            { -130.0, -15.0 },      // chorus: measured exact / -18.7
+            { -90.0,  -19.0 },      // flanger: measured -93.0 / -22.4
+            { -121.0, -61.0 },      // phaser: measured -124.8 / -64.4
+            { -130.0, -16.0 }       // ensemble: measured exact / -19.0
+        };
+
+        bool ok = true;
+
+        for (int controlInterval : { 1, ModulationEngine::kDefaultControlInterval })
+            for (int mode = 0; mode < 4; ++mode)
+                for (int depth : { 0, 80 })
+                {
+                    const auto name = juce::String("null/baseline/") + modeNames[mode] + "/i" + juce::String(controlInterval)
+                                    + (depth == 0 ? "/still" : "/swept");
+                    if (! name.contains(filter))
+                        continue;
+
+                    const double bound = depth == 0 ? bounds[mode].still : bounds[mode].swept;
+                    const auto test = renderAgainstReference(2, mode, 0, controlInterval, 0, true, depth);
+                    const bool passed = test.errorDb <= bound;
+                    ok = ok && passed;
+
+                    std::cout << (passed ? "PASS  " : "FAIL  ") << name.paddedRight(' ', 36)
+                              << juce::String(test.errorDb, 1) << " dB (bound " << juce::String(bound, 1)
+                              << " dB)  max error " << juce::String(test.maxError, 7) << "\n";
+                }
+
+        return ok;
+    }
+
+    // What each tap tier does to the top of the spectrum: a 10 kHz tone through
+    // a fixed delay half a sample off the grid, where interpolation loses the
+    // most. Linear rolls off by cos(pi f / fs), the cubic by much less, and the
+    // allpass not at all.
+    bool verifyInterpolation(const juce::String& filter)
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr double frequency = 10000.0;
+        constexpr int numSamples = 9600;
+        const double bounds[] = { -2.1, -0.6, -0.01 };   // measured -2.0, -0.53, 0.0
+        bool ok = true;
+
+        for (int interpolation = 0; interpolation < 3; ++interpolation)
+        {
+            const auto name = juce::String("interpolation/") + interpolationNames[interpolation];
+            if (! name.contains(filter))
+                continue;
+
+            StereoDelayLine<float> line;
+            line.prepare(sampleRate, 30.0f);
+
+            alignas(StereoDelayLine<float>::kAlignment) std::array<float, ModulationEngine::kMaxVoices> delays, increments {}, gains {};
+            delays.fill(20.5f);
+            gains[0] = 1.0f;
+
+            double inputEnergy = 0.0, outputEnergy = 0.0;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const auto x = static_cast<float>(std::sin(juce::MathConstants<double>::twoPi * frequency * i / sampleRate));
+                line.write(x, x);
+
+                float y = 0.0f;
+                switch (interpolation)
+                {
+                    case 1:  y = line.readVoices<DelayInterpolation::cubic>(0, delays.data(), increments.data(), gains.data(), 1); break;
+                    case 2:  y = line.readVoices<DelayInterpolation::allpass>(0, delays.data(), increments.data(), gains.data(), 1); break;
+                    default: y = line.readVoices<DelayInterpolation::linear>(0, delays.data(), increments.data(), gains.data(), 1); break;
+                }
+
+                line.advance();
+
+                // Past the delay and the allpass's settling
+                if (i >= numSamples / 2)
+                {
+                    inputEnergy += static_cast<double>(x) * x;
+                    outputEnergy += static_cast<double>(y) * y;
+                }
+            }
+
+            const double gainDb = 10.0 * std::log10(outputEnergy / inputEnergy);
+            const bool passed = interpolation == 2 ? std::abs(gainDb) <= -bounds[interpolation]
+                                                   : gainDb >= bounds[interpolation];
+            ok = ok && passed;
+
+            std::cout << (passed ? "PASS  " : "FAIL  ") << name.paddedRight(' ', 36)
+                      << juce::String(gainDb, 2) << " dB at 10 kHz (bound " << juce::String(bounds[interpolation], 2) << " dB)\n";
+        }
+
+        return ok;
+    }
+
+    // Surround beds run one engine per L/R pair, one per centre channel and
+    // none on LFE. Feeding every channel the same stereo signal, the front pair
+    // must match a plain stereo render exactly, and the other channels must
+    // differ from it (rotated LFOs, mono centre, dry LFE). In 5.1, signal on
+    // only the centre or only the LFE must leave every other channel silent,
+    // and the LFE must come out as it went in.
+    bool verifyChannelLayouts(const juce::String& filter)
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr int blockSize = 128;
+        constexpr int numBlocks = 200;
+        bool ok = true;
+
+        const std::pair<int, const char*> layouts[] = { { 6, "5.1" }, { 8, "7.1" }, { 12, "7.1.4" } };
+
+        for (const auto& [numChannels, layoutName] : layouts)
+            for (int mode : { 0, 2 })
+            {
+                const auto name = juce::String("layout/") + layoutName + "/" + modeNames[mode];
+                if (! name.contains(filter))
+                    continue;
+
+                SwayAudioProcessor bed, stereo;
+                const bool supported = SwayTools::setChannelLayout(bed, numChannels);
+
+                for (auto* processor : { &bed, &stereo })
+                {
+                    SwayTools::applyParameter(*processor, "mode=" + juce::String(mode));
+                    SwayTools::applyParameter(*processor, "rate=70");
+                    SwayTools::applyParameter(*processor, "depth=80");
+                    processor->setRandomSeed(12345);
+                    processor->setRateAndBufferSizeDetails(sampleRate, blockSize);
+                    processor->prepareToPlay(sampleRate, blockSize);
+                }
+
+                juce::AudioBuffer<float> bedBuffer(numChannels, blockSize), stereoBuffer(2, blockSize);
+                juce::MidiBuffer midi;
+                juce::Random random(7);
+                double frontError = 0.0, rotatedDifference = 0.0;
+
+                for (int block = 0; supported && block < numBlocks; ++block)
+                {
+                    for (int i = 0; i < blockSize; ++i)
+                        for (int ch = 0; ch < 2; ++ch)
+                            stereoBuffer.setSample(ch, i, random.nextFloat() * 2.0f - 1.0f);
+
+                    for (int ch = 0; ch < numChannels; ++ch)
+                        bedBuffer.copyFrom(ch, 0, stereoBuffer, ch % 2, 0, blockSize);
+
+                    bed.processBlock(bedBuffer, midi);
+                    stereo.processBlock(stereoBuffer, midi);
+
+                    for (int ch = 0; ch < numChannels; ++ch)
+                        for (int i = 0; i < blockSize; ++i)
+                        {
+                            const double diff = std::abs(bedBuffer.getSample(ch, i) - stereoBuffer.getSample(ch % 2, i));
+                            if (ch < 2)
+                                frontError = juce::jmax(frontError, diff);
+                            else
+                                rotatedDifference = juce::jmax(rotatedDifference, diff);
+                        }
+                }
+
+                const bool passed = supported && frontError == 0.0 && rotatedDifference > 1.0e-3;
+                ok = ok && passed;
+
+                std::cout << (passed ? "PASS  " : "FAIL  ") << name.paddedRight(' ', 36)
+                          << (supported ? "front pair error " + juce::String(frontError, 7)
+                                            + ", rotated pairs differ by " + juce::String(rotatedDifference, 4)
+                                        : juce::String("layout not supported")) << "\n";
+            }
+
+        for (int mode : { 0, 2 })
+        {
+            const auto name = juce::String("layout/5.1/") + modeNames[mode] + "/centre-lfe";
+            if (! name.contains(filter))
+                continue;
+
+            constexpr int centre = 2, lfe = 3;
+            double leak = 0.0, lfeError = 0.0, centreWet = 0.0;
+            bool supported = true;
+
+            for (int source : { centre, lfe })
+            {
+                SwayAudioProcessor bed;
+                supported = supported && SwayTools::setChannelLayout(bed, 6);
+                SwayTools::applyParameter(bed, "mode=" + juce::String(mode));
+                SwayTools::applyParameter(bed, "feedback=60");
+                SwayTools::applyParameter(bed, "width=150");     // mid/side would carry one side into the other
+                bed.setRandomSeed(12345);
+                bed.setRateAndBufferSizeDetails(sampleRate, blockSize);
+                bed.prepareToPlay(sampleRate, blockSize);
+
+                juce::AudioBuffer<float> buffer(6, blockSize), input(1, blockSize);
+                juce::MidiBuffer midi;
+                juce::Random random(7);
+
+                for (int block = 0; supported && block < numBlocks; ++block)
+                {
+                    for (int i = 0; i < blockSize; ++i)
+                        input.setSample(0, i, random.nextFloat() * 2.0f - 1.0f);
+
+                    buffer.clear();
+                    buffer.copyFrom(source, 0, input, 0, 0, blockSize);
+                    bed.processBlock(buffer, midi);
+
+                    for (int ch = 0; ch < 6; ++ch)
+                        for (int i = 0; i < blockSize; ++i)
+                        {
+                            const double out = buffer.getSample(ch, i);
+                            if (ch != source)
+                                leak = juce::jmax(leak, std::abs(out));
+                            else if (source == lfe)
+                                lfeError = juce::jmax(lfeError, std::abs(out - input.getSample(0, i)));
+                            else
+                                centreWet = juce::jmax(centreWet, std::abs(out - input.getSample(0, i)));
+                        }
+                }
+            }
+
+            const bool passed = supported && leak == 0.0 && lfeError == 0.0 && centreWet > 1.0e-3;
+            ok = ok && passed;
+
+            std::cout << (passed ? "PASS  " : "FAIL  ") << name.paddedRight(' ', 36)
+                      << (supported ? "leak " + juce::String(leak, 7) + ", LFE error " + juce::String(lfeError, 7)
+                                        + ", centre wet by " + juce::String(centreWet, 4)
+                                    : juce::String("layout not supported")) << "\n";
+        }
+
+        return ok;
+    }
+
+    // The double path runs the same kernels at higher precision, so a float
+    // render of the same float input must match it to float rounding. Feedback
+    // and warmth stay on, and HQ covers the double oversampler.
+    bool verifyPrecision(const juce::String& filter)
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr int blockSize = 160;
+        constexpr int numBlocks = 300;
+        constexpr double bound = -100.0;
+        const char* const qualityNames[] = { "eco", "hq2x" };
+        bool ok = true;
+
+        for (int mode = 0; mode < 4; ++mode)
+            for (int quality = 0; quality < 2; ++quality)
+            {
+                const auto name = juce::String("precision/") + modeNames[mode] + "/" + qualityNames[quality];
+                if (! name.contains(filter))
+                    continue;
+
+                SwayAudioProcessor single, wide;
+                wide.setProcessingPrecision(juce::AudioProcessor::doublePrecision);
+
+                for (auto* processor : { &single, &wide })
+                {
+                    SwayTools::setChannelLayout(*processor, 2);
+                    for (const auto& assignment : { "mode=" + juce::String(mode), juce::String("rate=70"), juce::String("depth=80"),
+                                                    juce::String("feedback=50"), juce::String("warmth=40"),
+                                                    "warmthQuality=" + juce::String(quality), juce::String("voices=4") })
+                        SwayTools::applyParameter(*processor, assignment);
+
+                    processor->setRandomSeed(12345);
+                    processor->setRateAndBufferSizeDetails(sampleRate, blockSize);
+                    processor->prepareToPlay(sampleRate, blockSize);
+                }
+
+                juce::AudioBuffer<float> singleBuffer(2, blockSize);
+                juce::AudioBuffer<double> wideBuffer;
+                juce::MidiBuffer midi;
+                juce::Random random(7);
+                double errorEnergy = 0.0, referenceEnergy = 0.0;
+
+                for (int block = 0; block < numBlocks; ++block)
+                {
+                    for (int ch = 0; ch < 2; ++ch)
+                        for (int i = 0; i < blockSize; ++i)
+                            singleBuffer.setSample(ch, i, 0.5f * (random.nextFloat() * 2.0f - 1.0f));
+
+                    wideBuffer.makeCopyOf(singleBuffer);
+                    single.processBlock(singleBuffer, midi);
+                    wide.processBlock(wideBuffer, midi);
+
+                    for (int ch = 0; ch < 2; ++ch)
+                        for (int i = 0; i < blockSize; ++i)
+                        {
+                            const double want = wideBuffer.getSample(ch, i);
+                            const double diff = singleBuffer.getSample(ch, i) - want;
+                            errorEnergy += diff * diff;
+                            referenceEnergy += want * want;
+                        }
+                }
+
+                const double errorDb = 10.0 * std::log10(errorEnergy / referenceEnergy + 1.0e-30);
+                const bool passed = errorDb <= bound;
+                ok = ok && passed;
+
+                std::cout << (passed ? "PASS  " : "FAIL  ") << name.paddedRight(' ', 36)
+                          << "float vs double " << juce::String(errorDb, 1) << " dB (bound "
+                          << juce::String(bound, 1) << " dB)\n";
+            }
+
+        return ok;
+    }
+
+    // Idle mode: after the input stops, the processor must wait out the tail
+    // (at least getTailLengthSeconds() of silence at its output) before going
+    // idle, pass digital silence through untouched while idle, and wake on the
+    // first block of a tone that starts at zero without a step in the output.
+    bool verifyIdle(const juce::String& filter)
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr int blockSize = 128;
+        constexpr int signalSamples = 24000;
+        constexpr int silenceSamples = 4 * 48000;
+        constexpr int resumeSamples = 4800;
+        bool ok = true;
+
+        for (int mode = 0; mode < 4; ++mode)
+        {
+            const auto name = juce::String("idle/") + modeNames[mode];
+            if (! name.contains(filter))
+                continue;
+
+            SwayAudioProcessor processor;
+            SwayTools::setChannelLayout(processor, 2);
+            for (const auto& assignment : { "mode=" + juce::String(mode), juce::String("rate=70"), juce::String("depth=80"),
+                                            juce::String("feedback=70"), juce::String("warmth=40") })
+                SwayTools::applyParameter(processor, assignment);
+
+            processor.setRandomSeed(12345);
+            processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+            processor.prepareToPlay(sampleRate, blockSize);
+
+            juce::AudioBuffer<float> buffer(2, blockSize);
+            juce::MidiBuffer midi;
+            juce::Random random(7);
+            std::vector<float> input(static_cast<size_t>(blockSize));
+            int idleAfter = -1;             // samples after the input stopped until idle
+            int lastTailSample = 0;         // last output sample above the threshold, same origin
+            double idleOutputPeak = 0.0;
+            double outputStep = 0.0, inputStep = 0.0;
+            float previousOutput = 0.0f, previousInput = 0.0f;
+            bool wokeUp = false;
+
+            for (int pos = 0; pos < signalSamples + silenceSamples + resumeSamples; pos += blockSize)
+            {
+                for (int i = 0; i < blockSize; ++i)
+                {
+                    const int t = pos + i;
+                    float x = 0.0f;
+                    if (t < signalSamples)
+                        x = 0.5f * (random.nextFloat() * 2.0f - 1.0f);
+                    else if (t >= signalSamples + silenceSamples)
+                        x = 0.25f * std::sin(juce::MathConstants<float>::twoPi * 220.0f
+                                             * static_cast<float>(t - signalSamples - silenceSamples) / static_cast<float>(sampleRate));
+
+                    input[static_cast<size_t>(i)] = x;
+                    buffer.setSample(0, i, x);
+                    buffer.setSample(1, i, x);
+                }
+
+                const bool resuming = pos + blockSize > signalSamples + silenceSamples;
+                const bool wasIdle = processor.isIdle();
+                processor.processBlock(buffer, midi);
+
+                for (int i = 0; i < blockSize; ++i)
+                {
+                    const int t = pos + i - signalSamples;
+                    const float x = input[static_cast<size_t>(i)];
+                    const float y = buffer.getSample(0, i);
+
+                    const bool silentInput = t >= 0 && t < silenceSamples;
+
+                    if (silentInput && std::abs(y) > 1.0e-5f)
+                        lastTailSample = t;
+                    if (silentInput && wasIdle)
+                        idleOutputPeak = juce::jmax(idleOutputPeak, static_cast<double>(std::abs(y)));
+
+                    // The first 10 ms after the tone starts
+                    if (t >= silenceSamples && t < silenceSamples + 480)
+                    {
+                        outputStep = juce::jmax(outputStep, static_cast<double>(std::abs(y - previousOutput)));
+                        inputStep = juce::jmax(inputStep, static_cast<double>(std::abs(x - previousInput)));
+                    }
+
+                    previousOutput = y;
+                    previousInput = x;
+                }
+
+                if (idleAfter < 0 && processor.isIdle())
+                    idleAfter = pos + blockSize - signalSamples;
+                if (resuming && ! processor.isIdle())
+                    wokeUp = true;
+            }
+
+            const int tailSamples = static_cast<int>(processor.getTailLengthSeconds() * sampleRate);
+            const bool waitedOutTail = idleAfter >= 0 && idleAfter >= lastTailSample + tailSamples;
+            const bool passed = waitedOutTail && idleOutputPeak == 0.0 && wokeUp && outputStep <= 2.0 * inputStep;
+            ok = ok && passed;
+
+            std::cout << (passed ? "PASS  " : "FAIL  ") << name.paddedRight(' ', 36)
+                      << "tail " << juce::String(lastTailSample / sampleRate, 3) << " s, idle after "
+                      << juce::String(idleAfter / sampleRate, 3) << " s, wake-up step "
+                      << juce::String(outputStep, 4) << " (input " << juce::String(inputStep, 4) << ")\n";
+        }
+
+        return ok;
+    }
+
+    // Runs one configuration through processBlock the way a session would: odd
+    // block sizes, parameter changes between blocks (derived-state rebuilds,
+    // kernel switches), a tail dying into idle and waking up again. Returns the
+    // number of realtime violations the checker saw inside processBlock.
+    template <typename SampleType>
+    int countRealtimeViolations(int mode, int shape)
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr int maxBlockSize = 512;
+        const int blockSizes[] = { 512, 1, 17, 256, 64, 511 };
+
+        SwayAudioProcessor processor;
+        SwayTools::setChannelLayout(processor, 2);
+        for (const auto& assignment : { "mode=" + juce::String(mode), "shape=" + juce::String(shape),
+                                        juce::String("rate=70"), juce::String("depth=80"), juce::String("feedback=50"),
+                                        juce::String("warmth=40") })
+            SwayTools::applyParameter(processor, assignment);
+
+        processor.setProcessingPrecision(std::is_same_v<SampleType, double> ? juce::AudioProcessor::doublePrecision
+                                                                            : juce::AudioProcessor::singlePrecision);
+        processor.setRateAndBufferSizeDetails(sampleRate, maxBlockSize);
+        processor.prepareToPlay(sampleRate, maxBlockSize);
+
+        // Applied between blocks, a quarter of a second apart. Quality changes move
+        // the reported latency; warmth off and on takes Eco out of the path and back.
+        const juce::String changes[] = { "voices=8", "interpolation=1", "warmthQuality=1", "stages=12",
+                                         "interpolation=2", "warmthQuality=2", "spread=90", "warmthQuality=0",
+                                         "warmth=0", "width=150", "warmth=40", "mode=" + juce::String((mode + 1) % 4),
+                                         "shape=" + juce::String((shape + 1) % 4) };
+
+        juce::AudioBuffer<SampleType> buffer(2, maxBlockSize);
+        juce::MidiBuffer midi;
+        juce::Random random(7);
+
+        const int changeEvery = static_cast<int>(sampleRate / 4);
+        const int signalSamples = changeEvery * (juce::numElementsInArray(changes) + 1);
+        const int silenceSamples = static_cast<int>(sampleRate);    // twice the tail: goes idle
+        const int totalSamples = signalSamples + silenceSamples + changeEvery;
+        int nextChange = changeEvery;
+        int changeIndex = 0;
+
+        RealtimeSafety::resetViolations();
+
+        for (int pos = 0, block = 0; pos < totalSamples; ++block)
+        {
+            const int numSamples = blockSizes[block % juce::numElementsInArray(blockSizes)];
+            buffer.setSize(2, numSamples, false, false, true);
+
+            const bool silent = pos >= signalSamples && pos < signalSamples + silenceSamples;
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < numSamples; ++i)
+                    buffer.setSample(ch, i, silent ? SampleType(0) : static_cast<SampleType>(0.25f * (random.nextFloat() * 2.0f - 1.0f)));
+
+            processor.processBlock(buffer, midi);
+            pos += numSamples;
+
+            if (pos >= nextChange && changeIndex < juce::numElementsInArray(changes))
+            {
+                SwayTools::applyParameter(processor, changes[changeIndex++]);
+                nextChange += changeEvery;
+            }
+        }
+
+        processor.releaseResources();
+        return RealtimeSafety::getNumViolations();
+    }
+
+    // processBlock must not allocate, lock or block. Only a SWAY_RT_CHECKS build
+    // can see those calls; elsewhere the check is skipped.
+    bool verifyRealtimeSafety(const juce::String& filter)
+    {
+        if (! RealtimeSafety::isEnabled())
+        {
+            if (filter.isEmpty() || filter.startsWith("realtime"))
+                std::cout << "SKIP  realtime (configure with -DSWAY_RT_CHECKS=ON)\n";
+            return true;
+        }
+
+        bool ok = true;
+
+        for (int mode = 0; mode < 4; ++mode)
+            for (int shape = 0; shape < 4; ++shape)
+                for (bool doublePrecision : { false, true })
+                {
+                    const auto name = juce::String("realtime/") + modeNames[mode] + "/" + shapeNames[shape]
+                                    + (doublePrecision ? "/f64" : "");
+                    if (! name.contains(filter))
+                        continue;
+
+                    const int violations = doublePrecision ? countRealtimeViolations<double>(mode, shape)
+                                                           : countRealtimeViolations<float>(mode, shape);
+                    const bool passed = violations == 0;
+                    ok = ok && passed;
+
+                    std::cout << (passed ? "PASS  " : "FAIL  ") << name.paddedRight(' ', 36)
+                              << violations << " violations\n";
+                }
+
+        return ok;
+    }
+
+    //==============================================================================
+    juce::var toJson(const std::vector<Result>& results, const Options& options)
+    {
+        juce::Array<juce::var> entries;
+        for (const auto& result : results)
+        {
+            auto* entry = new juce::DynamicObject();
+            entry->setProperty("name", result.name);
+            for (const auto& property : result.details.getDynamicObject()->getProperties())
+                entry->setProperty(property.name, property.value);
+            entry->setProperty("nsPerSample", result.nsPerSample);
+            entry->setProperty("realtimeFactor", result.realtimeFactor);
+            entries.add(juce::var(entry));
+        }
+
+        auto* machine = new juce::DynamicObject();
+        machine->setProperty("cpu", juce::SystemStats::getCpuModel());
+        machine->setProperty("os", juce::SystemStats::getOperatingSystemName());
+        machine->setProperty("simdLanes", static_cast<int>(juce::dsp::SIMDRegister<float>::size()));
+
+        auto* root = new juce::DynamicObject();
+        root->setProperty("version", 1);
+        root->setProperty("machine", juce::var(machine));
+        root->setProperty("secondsPerMeasurement", options.seconds);
+        root->setProperty("repeats", options.repeats);
+        root->setProperty("results", entries);
+        return juce::var(root);
+    }
+
+    // Returns false if any configuration in both runs slowed down past the threshold
+    bool compareWithBaseline(const std::vector<Result>& results, const Options& options)
+    {
+        const auto baseline = juce::JSON::parse(options.baselineFile);
+        const auto* entries = baseline.getProperty("results", {}).getArray();
+        if (entries == nullptr)
+        {
+            std::cerr << "sway_bench: no results in " << options.baselineFile.getFullPathName() << "\n";
+            return false;
+        }
+
+        std::map<juce::String, double> baselineNs;
+        for (const auto& entry : *entries)
+            baselineNs[entry.getProperty("name", {}).toString()] = static_cast<double>(entry.getProperty("nsPerSample", 0.0));
+
+        int numRegressions = 0, numCompared = 0;
+
+        for (const auto& result : results)
+        {
+            const auto it = baselineNs.find(result.name);
+            if (it == baselineNs.end() || it->second <= 0.0)
+                continue;
+
+            ++numCompared;
+            const double changePercent = (result.nsPerSample / it->second - 1.0) * 100.0;
+            const bool regressed = changePercent > options.thresholdPercent;
+            numRegressions += regressed ? 1 : 0;
+
+            if (regressed || changePercent < -options.thresholdPercent)
+                std::cerr << (regressed ? "SLOWER  " : "FASTER  ") << result.name.paddedRight(' ', 36)
+                          << juce::String(it->second, 2) << " -> " << juce::String(result.nsPerSample, 2)
+                          << " ns/sample (" << (changePercent > 0.0 ? "+" : "") << juce::String(changePercent, 1) << "%)\n";
+        }
+
+        std::cerr << numCompared << " configurations compared, " << numRegressions
+                  << " regressed by more than " << juce::String(options.thresholdPercent, 1) << "%\n";
+        return numRegressions == 0;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    Options options;
+    if (const auto parsed = parseOptions(argc, argv, options); parsed.failed())
+    {
+        std::cerr << "sway_bench: " << parsed.getErrorMessage() << "\n";
+        return 1;
+    }
+
+    if (options.verify)
+    {
+        const bool fastMathOk = verifyFastMath(options.filter);
+        const bool wavetablesOk = verifyWavetables(options.filter);
+        const bool coefficientsOk = verifyPhaserCoefficients(options.filter);
+        const bool nullTestsOk = verifyAgainstReference(options.filter);
+        const bool baselineOk = verifyAgainstBaseline(options.filter);
+        const bool interpolationOk = verifyInterpolation(options.filter);
+        const bool layoutsOk = verifyChannelLayouts(options.filter);
+        const bool precisionOk = verifyPrecision(options.filter);
+        const bool idleOk = verifyIdle(options.filter);
+        return verifyRealtimeSafety(options.filter) && idleOk && precisionOk && layoutsOk && interpolationOk && nullTestsOk && baselineOk
+                   && coefficientsOk && wavetablesOk && fastMathOk ? 0 : 1;
+    }
+
+    const auto noise = makeNoise();
+    std::vector<Result> results;
+
+    auto report = [&](const Result& result)
+    {
+        std::cerr << result.name.paddedRight(' ', 36) << juce::String(result.nsPerSample, 2) << " ns/sample  "
+                  << juce::String(result.realtimeFactor, 0) << "x real time\n";
+        results.push_back(result);
+    };
+
+    for (const auto& config : buildMatrix(options.full))
+        if (config.getName().contains(options.filter))
+            report(runConfig(config, options, noise));
+
+    for (int stages = PhaserCascade<float>::kMinStages; stages <= PhaserCascade<float>::kMaxStages; ++stages)
+        for (bool templated : { true, false })
+            if (getCascadeName(stages, templated).contains(options.filter))
+                report(runCascade(stages, templated, options, noise));
+
+    for (int variant = 0; variant < juce::numElementsInArray(warmthNames); ++variant)
+        if ((juce::String("warmth/") + warmthNames[variant]).contains(options.filter))
+            report(runWarmth(variant, options, noise));
+
+    const auto json = juce::JSON::toString(toJson(results, options));
+    if (options.outputFile != juce::File())
+        options.outputFile.replaceWithText(json);
+    else
+        std::cout << json << "\n";
+
+    if (options.baselineFile != juce::File())
+        return compareWithBaseline(results, options) ? 0 : 1;
+
+    return 0;
+}
@@ -0,0 +1,319 @@
+/*
+  ==============================================================================
+    sway_render - offline batch renderer for SWAY
+
+    Usage:
+      sway_render [options] <input files...>
+
+      --state <file>       preset (APVTS XML or binary plugin state)
+      --set <id>=<value>   parameter override, repeatable (after --state)
+      --seed <n>           Random-shape seed for reproducible renders (0 = random)
+      --out <dir>          output directory (default: next to each input)
+      --jobs <n>           worker threads (default: one per core)
+      --block <n>          processing block size (default: 512)
+      --tail               append the effect tail instead of keeping the input length
+      --list-params        print parameter IDs and defaults, then exit
+
+    Each worker owns one SwayAudioProcessor and pulls files from a shared
+    queue. Output is WAV at the input's rate, channel count and bit depth,
+    written as <name>_sway.wav with the plugin latency removed.
+  ==============================================================================
+*/
+
+#include <juce_audio_formats/juce_audio_formats.h>
+#include "ToolUtils.h"
+
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+    struct Options
+    {
+        juce::File stateFile;
+        juce::StringArray parameterOverrides;
+        juce::int64 seed = -1;          // -1 keeps the preset's seed
+        juce::File outputDir;
+        juce::Array<juce::File> inputs;
+        int numJobs = 0;
+        int blockSize = 512;
+        bool renderTail = false;
+        bool listParams = false;
+    };
+
+    struct FileResult
+    {
+        bool ok = false;
+        juce::String message;
+        juce::int64 numFrames = 0;
+        int numChannels = 0;
+        double sampleRate = 0.0;
+        double processSeconds = 0.0;    // time spent inside processBlock
+    };
+
+    void printUsage()
+    {
+        std::cout << "usage: sway_render [--state file] [--set id=value ...] [--seed n] [--out dir]\n"
+                     "                   [--jobs n] [--block n] [--tail] [--list-params] inputs...\n";
+    }
+
+    juce::Result parseOptions(int argc, char* argv[], Options& options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const juce::String arg(argv[i]);
+            const bool hasValue = i + 1 < argc;
+
+            auto takeValue = [&]() { return juce::String(argv[++i]); };
+
+            if (arg == "--state" && hasValue)        options.stateFile = juce::File::getCurrentWorkingDirectory().getChildFile(takeValue());
+            else if (arg == "--set" && hasValue)     options.parameterOverrides.add(takeValue());
+            else if (arg == "--seed" && hasValue)    options.seed = takeValue().getLargeIntValue();
+            else if (arg == "--out" && hasValue)     options.outputDir = juce::File::getCurrentWorkingDirectory().getChildFile(takeValue());
+            else if (arg == "--jobs" && hasValue)    options.numJobs = takeValue().getIntValue();
+            else if (arg == "--block" && hasValue)   options.blockSize = takeValue().getIntValue();
+            else if (arg == "--tail")                options.renderTail = true;
+            else if (arg == "--list-params")         options.listParams = true;
+            else if (arg.startsWith("-"))            return juce::Result::fail("unknown option " + arg);
+            else                                     options.inputs.add(juce::File::getCurrentWorkingDirectory().getChildFile(arg));
+        }
+
+        if (options.blockSize < 1)
+            return juce::Result::fail("--block must be positive");
+
+        if (options.numJobs < 1)
+            options.numJobs = juce::jmax(1, juce::SystemStats::getNumCpus());
+
+        return juce::Result::ok();
+    }
+
+    juce::File getOutputFile(const Options& options, const juce::File& input)
+    {
+        const auto dir = options.outputDir != juce::File() ? options.outputDir : input.getParentDirectory();
+        return dir.getChildFile(input.getFileNameWithoutExtension() + "_sway.wav");
+    }
+
+    FileResult renderFile(SwayAudioProcessor& processor, juce::AudioFormatManager& formats,
+                          const Options& options, const juce::File& input)
+    {
+        FileResult result;
+
+        std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(input));
+        if (reader == nullptr)
+        {
+            result.message = "unsupported or unreadable file";
+            return result;
+        }
+
+        result.numChannels = static_cast<int>(reader->numChannels);
+        result.sampleRate = reader->sampleRate;
+        result.numFrames = reader->lengthInSamples;
+
+        processor.releaseResources();
+        if (! SwayTools::setChannelLayout(processor, result.numChannels))
+        {
+            result.message = juce::String(result.numChannels) + " channels not supported (up to 12)";
+            return result;
+        }
+
+        processor.setNonRealtime(true);
+        processor.setRateAndBufferSizeDetails(result.sampleRate, options.blockSize);
+        processor.prepareToPlay(result.sampleRate, options.blockSize);
+
+        const auto outputFile = getOutputFile(options, input);
+        if (outputFile == input)
+        {
+            result.message = "output would overwrite the input";
+            return result;
+        }
+
+        outputFile.getParentDirectory().createDirectory();
+        outputFile.deleteFile();
+
+        auto stream = outputFile.createOutputStream();
+        const int bitDepth = reader->usesFloatingPointData ? 32
+                           : juce::jlimit(16, 24, static_cast<int>(reader->bitsPerSample));
+
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatWriter> writer(stream != nullptr
+            ? wav.createWriterFor(stream.get(), result.sampleRate, reader->numChannels, bitDepth, {}, 0)
+            : nullptr);
+
+        if (writer == nullptr)
+        {
+            result.message = "cannot write " + outputFile.getFullPathName();
+            return result;
+        }
+        stream.release();   // owned by the writer now
+
+        // Feed latency + tail worth of silence after the input, and drop the
+        // first latency samples so the output lines up with the input
+        const juce::int64 latency = processor.getLatencySamples();
+        const juce::int64 tail = options.renderTail
+            ? static_cast<juce::int64>(processor.getTailLengthSeconds() * result.sampleRate)
+            : 0;
+        const juce::int64 totalFrames = result.numFrames + latency + tail;
+        juce::int64 framesToSkip = latency;
+
+        juce::AudioBuffer<float> buffer(result.numChannels, options.blockSize);
+        juce::MidiBuffer midi;
+
+        for (juce::int64 pos = 0; pos < totalFrames; pos += options.blockSize)
+        {
+            const int numSamples = static_cast<int>(juce::jmin<juce::int64>(options.blockSize, totalFrames - pos));
+            buffer.setSize(result.numChannels, numSamples, false, false, true);
+            buffer.clear();
+
+            if (pos < result.numFrames)
+                reader->read(&buffer, 0, static_cast<int>(juce::jmin<juce::int64>(numSamples, result.numFrames - pos)),
+                             pos, true, true);
+
+            const double start = juce::Time::getMillisecondCounterHiRes();
+            processor.processBlock(buffer, midi);
+            result.processSeconds += (juce::Time::getMillisecondCounterHiRes() - start) * 0.001;
+
+            const int skip = static_cast<int>(juce::jmin<juce::int64>(framesToSkip, numSamples));
+            framesToSkip -= skip;
+
+            if (skip < numSamples && ! writer->writeFromAudioSampleBuffer(buffer, skip, numSamples - skip))
+            {
+                result.message = "write failed";
+                return result;
+            }
+        }
+
+        result.ok = true;
+        result.message = outputFile.getFullPathName();
+        return result;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    Options options;
+    if (const auto parsed = parseOptions(argc, argv, options); parsed.failed())
+    {
+        std::cerr << "sway_render: " << parsed.getErrorMessage() << "\n";
+        printUsage();
+        return 1;
+    }
+
+    // Resolve the preset and overrides once; every worker restores the same state
+    juce::MemoryBlock state;
+    {
+        SwayAudioProcessor reference;
+
+        if (options.stateFile != juce::File())
+        {
+            if (const auto loaded = SwayTools::loadStateFile(reference, options.stateFile); loaded.failed())
+            {
+                std::cerr << "sway_render: " << loaded.getErrorMessage() << "\n";
+                return 1;
+            }
+        }
+
+        for (const auto& assignment : options.parameterOverrides)
+        {
+            if (const auto applied = SwayTools::applyParameter(reference, assignment); applied.failed())
+            {
+                std::cerr << "sway_render: " << applied.getErrorMessage() << "\n";
+                return 1;
+            }
+        }
+
+        if (options.seed >= 0)
+            reference.setRandomSeed(static_cast<juce::uint32>(options.seed));
+
+        if (options.listParams)
+        {
+            std::cout << SwayTools::describeParameters(reference);
+            return 0;
+        }
+
+        reference.getStateInformation(state);
+    }
+
+    if (options.inputs.isEmpty())
+    {
+        printUsage();
+        return 1;
+    }
+
+    const int numWorkers = juce::jmin(options.numJobs, options.inputs.size());
+
+    std::vector<std::unique_ptr<SwayAudioProcessor>> processors;
+    for (int w = 0; w < numWorkers; ++w)
+    {
+        processors.push_back(std::make_unique<SwayAudioProcessor>());
+        processors.back()->setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+    }
+
+    std::vector<FileResult> results(static_cast<size_t>(options.inputs.size()));
+    std::atomic<int> nextInput { 0 };
+    std::mutex printLock;
+
+    const double batchStart = juce::Time::getMillisecondCounterHiRes();
+
+    std::vector<std::thread> workers;
+    for (auto& processor : processors)
+    {
+        workers.emplace_back([&, proc = processor.get()]
+        {
+            juce::AudioFormatManager formats;
+            formats.registerBasicFormats();
+
+            for (int index = nextInput++; index < options.inputs.size(); index = nextInput++)
+            {
+                const auto& input = options.inputs.getReference(index);
+                auto& result = results[static_cast<size_t>(index)];
+                result = renderFile(*proc, formats, options, input);
+
+                const std::lock_guard<std::mutex> lock(printLock);
+                if (result.ok)
+                {
+                    const double audioSeconds = static_cast<double>(result.numFrames) / result.sampleRate;
+                    std::cout << input.getFileName() << " -> " << result.message << "  ("
+                              << juce::String(audioSeconds / juce::jmax(1.0e-9, result.processSeconds), 1) << "x real time)\n";
+                }
+                else
+                {
+                    std::cerr << input.getFileName() << ": " << result.message << "\n";
+                }
+            }
+        });
+    }
+
+    for (auto& worker : workers)
+        worker.join();
+
+    const double wallSeconds = (juce::Time::getMillisecondCounterHiRes() - batchStart) * 0.001;
+
+    juce::int64 totalSamples = 0;
+    double totalProcessSeconds = 0.0;
+    int numFailed = 0;
+
+    for (const auto& result : results)
+    {
+        if (! result.ok)
+        {
+            ++numFailed;
+            continue;
+        }
+
+        totalSamples += result.numFrames * result.numChannels;
+        totalProcessSeconds += result.processSeconds;
+    }
+
+    std::cout << "\n" << (options.inputs.size() - numFailed) << " of " << options.inputs.size()
+              << " files rendered on " << numWorkers << " worker(s) in " << juce::String(wallSeconds, 2) << " s\n"
+              << "throughput: " << juce::String(static_cast<double>(totalSamples) / juce::jmax(1.0e-9, wallSeconds), 0)
+              << " samples/s wall, "
+              << juce::String(static_cast<double>(totalSamples) / juce::jmax(1.0e-9, totalProcessSeconds), 0)
+              << " samples/s per worker (processBlock only)\n";
+
+    return numFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "PluginProcessor.h"
+#include "ParameterIDs.h"
+
+// Shared setup for the headless tools: presets, parameter overrides and bus layouts.
+namespace SwayTools
+{
+    // Loads a preset: either the APVTS XML (as written by getStateInformation
+    // before binary wrapping) or a binary plugin state blob saved by a host.
+    inline juce::Result loadStateFile(SwayAudioProcessor& processor, const juce::File& file)
+    {
+        juce::MemoryBlock data;
+        if (! file.loadFileAsData(data))
+            return juce::Result::fail("cannot read " + file.getFullPathName());
+
+        auto xml = juce::parseXML(data.toString());
+        if (xml == nullptr)
+            xml = juce::AudioProcessor::getXmlFromBinary(data.getData(), static_cast<int>(data.getSize()));
+
+        if (xml == nullptr || ! xml->hasTagName(processor.getAPVTS().state.getType()))
+            return juce::Result::fail(file.getFileName() + " is not a Sway preset");
+
+        // Through setStateInformation so non-parameter state (e.g. the seed) is restored too
+        juce::MemoryBlock state;
+        juce::AudioProcessor::copyXmlToBinary(*xml, state);
+        processor.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+        return juce::Result::ok();
+    }
+
+    // Applies "id=value". Values are in the parameter's own units (e.g. rate=40,
+    // warmthQuality=2); choice and bool parameters also accept their text
+    // (mode=Flanger, bypass=On).
+    inline juce::Result applyParameter(SwayAudioProcessor& processor, const juce::String& assignment)
+    {
+        const auto id = assignment.upToFirstOccurrenceOf("=", false, false).trim();
+        const auto valueText = assignment.fromFirstOccurrenceOf("=", false, false).trim();
+
+        auto* param = processor.getAPVTS().getParameter(id);
+        if (param == nullptr)
+            return juce::Result::fail("unknown parameter '" + id + "'");
+        if (valueText.isEmpty())
+            return juce::Result::fail("missing value for '" + id + "'");
+
+        const bool numeric = valueText.containsOnly("0123456789.-+eE");
+        param->setValueNotifyingHost(numeric ? param->convertTo0to1(valueText.getFloatValue())
+                                             : param->getValueForText(valueText));
+        return juce::Result::ok();
+    }
+
+    // One "id  current value  (name)" line per parameter, for --list-params
+    inline juce::String describeParameters(SwayAudioProcessor& processor)
+    {
+        juce::String text;
+        for (auto* param : processor.getParameters())
+            if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(param))
+                text << ranged->getParameterID().paddedRight(' ', 16)
+                     << ranged->getCurrentValueAsText().paddedRight(' ', 10)
+                     << "(" << ranged->getName(64) << ")\n";
+        return text;
+    }
+
+    // Matching input and output layout for a channel count: mono, stereo, 5.1, 7.1
+    // and 7.1.4 by their usual names, anything else the processor accepts as discrete
+    inline bool setChannelLayout(SwayAudioProcessor& processor, int numChannels)
+    {
+        if (numChannels < 1)
+            return false;
+
+        juce::AudioChannelSet set;
+        switch (numChannels)
+        {
+            case 1:  set = juce::AudioChannelSet::mono(); break;
+            case 2:  set = juce::AudioChannelSet::stereo(); break;
+            case 6:  set = juce::AudioChannelSet::create5point1(); break;
+            case 8:  set = juce::AudioChannelSet::create7point1(); break;
+            case 12: set = juce::AudioChannelSet::create7point1point4(); break;
+            default: set = juce::AudioChannelSet::discreteChannels(numChannels); break;
+        }
+
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add(set);
+        layout.outputBuses.add(set);
+        return processor.setBusesLayout(layout);
+    }
+}
@@ -1,10 +1,19 @@
+import { useEffect } from 'react';
 import { useSliderParam, useToggleParam, useChoiceParam } from './hooks/useJuceParam';
 import { SwayVisualizer } from './components/SwayVisualizer';
+import { emitEvent } from './lib/juce-bridge';
 import './index.css';
 
 // Mode names
 const modeNames = ['Chorus', 'Flanger', 'Phaser', 'Ensemble'];
 const shapeNames = ['Sine', 'Triangle', 'Square', 'Random'];
+const qualityNames = ['Eco', '2x', '4x'];
+const interpolationNames = ['Linear', 'Cubic', 'Allpass'];
+const interpolationTitles = [
+  'Cheapest, softens the highs',
+  '4-point Hermite, flat much higher up',
+  'Flat at every frequency, flanger only',
+];
 
 function App() {
   // Parameters
@@ -17,17 +26,26 @@ function App() {
   const voices = useSliderParam('voices', 2.0);
   const spread = useSliderParam('spread', 50.0);
   const warmth = useSliderParam('warmth', 0.0);
+  const warmthQuality = useChoiceParam('warmthQuality', 3, 0);
+  const interpolation = useChoiceParam('interpolation', 3, 0);
   const stages = useSliderParam('stages', 4.0);
   const color = useSliderParam('color', 50.0);
   const mix = useSliderParam('mix', 50.0);
   const width = useSliderParam('width', 100.0);
   const bypass = useToggleParam('bypass', false);
 
+  // Lets the plugin time editor opens and know when a pooled page is ready
+  useEffect(() => {
+    emitEvent('uiReady');
+  }, []);
+
   // Show different controls based on mode
   const isChorus = mode.value === 0;
   const isFlanger = mode.value === 1;
   const isPhaser = mode.value === 2;
   const isEnsemble = mode.value === 3;
+  // Allpass is the flanger's; the other delay modes play it as Cubic
+  const activeInterpolation = !isFlanger && interpolation.value === 2 ? 1 : interpolation.value;
 
   return (
     <div className={`app ${bypass.value ? 'bypassed' : ''}`}>
@@ -187,6 +205,23 @@ function App() {
                 />
               </>
             )}
+            {!isPhaser && (
+              <div className="shape-selector">
+                <label>Interp</label>
+                <div className="shape-buttons">
+                  {interpolationNames.slice(0, isFlanger ? 3 : 2).map((name, i) => (
+                    <button
+                      key={name}
+                      className={`shape-btn quality-btn ${activeInterpolation === i ? 'active' : ''}`}
+                      onClick={() => interpolation.setChoice(i)}
+                      title={interpolationTitles[i]}
+                    >
+                      {name}
+                    </button>
+                  ))}
+                </div>
+              </div>
+            )}
             <Knob
               label="Warmth"
               value={warmth.value}
@@ -197,6 +232,21 @@ function App() {
               max={100}
               unit="%"
             />
+            <div className="shape-selector">
+              <label>Quality</label>
+              <div className="shape-buttons">
+                {qualityNames.map((name, i) => (
+                  <button
+                    key={name}
+                    className={`shape-btn quality-btn ${warmthQuality.value === i ? 'active' : ''}`}
+                    onClick={() => warmthQuality.setChoice(i)}
+                    title={i === 0 ? 'Antialiased, no latency' : `${name} oversampled`}
+                  >
+                    {name}
+                  </button>
+                ))}
+              </div>
+            </div>
           </div>
         </div>
 
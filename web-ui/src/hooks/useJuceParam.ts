@@ -1,57 +1,37 @@
-import { useState, useEffect, useCallback, useRef } from 'react';
-import { getSliderState, getToggleState, isInJuceWebView } from '../lib/juce-bridge';
+import { useState, useEffect, useCallback } from 'react';
+import {
+  subscribeParameter,
+  setParameter,
+  setParameterNormalised,
+  beginParameterGesture,
+  endParameterGesture,
+} from '../lib/parameter-stream';
 
 /**
  * Hook for slider/knob parameters (continuous values)
  */
 export function useSliderParam(paramId: string, defaultValue: number = 0) {
   const [value, setValue] = useState(defaultValue);
-  const sliderStateRef = useRef<ReturnType<typeof getSliderState>>(null);
 
-  useEffect(() => {
-    if (!isInJuceWebView()) return;
-
-    const state = getSliderState(paramId);
-    sliderStateRef.current = state;
-
-    if (state) {
-      // Get initial value
-      setValue(state.getScaledValue());
-
-      // Listen for changes from JUCE
-      const handleChange = () => {
-        setValue(state.getScaledValue());
-      };
-
-      // Poll for changes (JUCE relay updates)
-      const interval = setInterval(handleChange, 16);
-      return () => clearInterval(interval);
-    }
-  }, [paramId]);
+  // Updates arrive batched, one message per UI frame for all parameters
+  useEffect(() => subscribeParameter(paramId, setValue), [paramId]);
 
   const setParam = useCallback((newValue: number) => {
     setValue(newValue);
-    if (sliderStateRef.current) {
-      sliderStateRef.current.setScaledValue(newValue);
-    }
-  }, []);
+    setParameter(paramId, newValue);
+  }, [paramId]);
 
   const setNormalized = useCallback((newValue: number) => {
-    if (sliderStateRef.current) {
-      sliderStateRef.current.setNormalisedValue(newValue);
-      setValue(sliderStateRef.current.getScaledValue());
-    } else {
-      setValue(newValue);
-    }
-  }, []);
+    setValue(setParameterNormalised(paramId, newValue));
+  }, [paramId]);
 
   const dragStart = useCallback(() => {
-    sliderStateRef.current?.sliderDragStarted();
-  }, []);
+    beginParameterGesture(paramId);
+  }, [paramId]);
 
   const dragEnd = useCallback(() => {
-    sliderStateRef.current?.sliderDragEnded();
-  }, []);
+    endParameterGesture(paramId);
+  }, [paramId]);
 
   return { value, setValue: setParam, setNormalized, dragStart, dragEnd };
 }
@@ -61,75 +41,36 @@ export function useSliderParam(paramId: string, defaultValue: number = 0) {
  */
 export function useToggleParam(paramId: string, defaultValue: boolean = false) {
   const [value, setValue] = useState(defaultValue);
-  const toggleStateRef = useRef<ReturnType<typeof getToggleState>>(null);
-
-  useEffect(() => {
-    if (!isInJuceWebView()) return;
 
-    const state = getToggleState(paramId);
-    toggleStateRef.current = state;
-
-    if (state) {
-      setValue(state.getValue());
-
-      const handleChange = () => {
-        setValue(state.getValue());
-      };
-
-      const interval = setInterval(handleChange, 16);
-      return () => clearInterval(interval);
-    }
-  }, [paramId]);
+  useEffect(() => subscribeParameter(paramId, (v) => setValue(v >= 0.5)), [paramId]);
 
   const toggle = useCallback(() => {
     const newValue = !value;
     setValue(newValue);
-    if (toggleStateRef.current) {
-      toggleStateRef.current.setValue(newValue);
-    }
-  }, [value]);
+    setParameter(paramId, newValue ? 1 : 0);
+  }, [paramId, value]);
 
   const setParam = useCallback((newValue: boolean) => {
     setValue(newValue);
-    if (toggleStateRef.current) {
-      toggleStateRef.current.setValue(newValue);
-    }
-  }, []);
+    setParameter(paramId, newValue ? 1 : 0);
+  }, [paramId]);
 
   return { value, toggle, setValue: setParam };
 }
 
 /**
- * Hook for choice/combo parameters (using slider relay with integer mapping)
+ * Hook for choice/combo parameters (values are choice indices)
  */
 export function useChoiceParam(paramId: string, numChoices: number, defaultValue: number = 0) {
   const [value, setValue] = useState(defaultValue);
-  const sliderStateRef = useRef<ReturnType<typeof getSliderState>>(null);
 
-  useEffect(() => {
-    if (!isInJuceWebView()) return;
-
-    const state = getSliderState(paramId);
-    sliderStateRef.current = state;
-
-    if (state) {
-      setValue(Math.round(state.getScaledValue()));
-
-      const handleChange = () => {
-        setValue(Math.round(state.getScaledValue()));
-      };
-
-      const interval = setInterval(handleChange, 16);
-      return () => clearInterval(interval);
-    }
-  }, [paramId]);
+  useEffect(() => subscribeParameter(paramId, (v) => setValue(Math.round(v))), [paramId]);
 
   const setChoice = useCallback((choice: number) => {
-    setValue(choice);
-    if (sliderStateRef.current) {
-      sliderStateRef.current.setScaledValue(choice);
-    }
-  }, []);
+    const clamped = Math.max(0, Math.min(numChoices - 1, choice));
+    setValue(clamped);
+    setParameter(paramId, clamped);
+  }, [paramId, numChoices]);
 
   return { value, setChoice };
 }
@@ -1,5 +1,5 @@
 import { useState, useEffect, useCallback } from 'react';
-import { isInJuceWebView, addEventListener, removeEventListener } from '../lib/juce-bridge';
+import { isInJuceWebView, addEventListener, removeEventListener, readFloat32Frames } from '../lib/juce-bridge';
 
 export interface SwayVisualizerData {
   lfoPhase: number;
@@ -12,6 +12,10 @@ export interface SwayVisualizerData {
   mode: number;
 }
 
+// Frame layout written by VisualizerTransport (Source/VisualizerTransport.h)
+const FRAME_VERSION = 1;
+const FRAME_VOICES_OFFSET = 10;
+
 const defaultData: SwayVisualizerData = {
   lfoPhase: 0,
   lfoValue: 0,
@@ -26,19 +30,26 @@ const defaultData: SwayVisualizerData = {
 export function useVisualizerData(): SwayVisualizerData {
   const [data, setData] = useState<SwayVisualizerData>(defaultData);
 
-  const handleVisualizerData = useCallback((eventData: any) => {
-    if (eventData && typeof eventData === 'object') {
-      setData({
-        lfoPhase: eventData.lfoPhase ?? 0,
-        lfoValue: eventData.lfoValue ?? 0,
-        stereoPhaseL: eventData.stereoPhaseL ?? 0,
-        stereoPhaseR: eventData.stereoPhaseR ?? 0,
-        modDepthL: eventData.modDepthL ?? 0,
-        modDepthR: eventData.modDepthR ?? 0,
-        voicePhases: eventData.voicePhases ?? [0, 0, 0, 0],
-        mode: eventData.mode ?? 0,
-      });
+  const handleVisualizerFrames = useCallback((payload: unknown) => {
+    const frames = readFloat32Frames(payload);
+    if (!frames || frames.version !== FRAME_VERSION || frames.count === 0 || frames.stride < FRAME_VOICES_OFFSET) {
+      return;
     }
+
+    // Frames arrive oldest first; the canvas only needs the newest
+    const frame = frames.data.subarray((frames.count - 1) * frames.stride, frames.count * frames.stride);
+    const numVoices = Math.min(frame[9], frames.stride - FRAME_VOICES_OFFSET);
+
+    setData({
+      lfoPhase: frame[1],
+      lfoValue: frame[2],
+      stereoPhaseL: frame[3],
+      stereoPhaseR: frame[4],
+      modDepthL: frame[5],
+      modDepthR: frame[6],
+      voicePhases: Array.from(frame.subarray(FRAME_VOICES_OFFSET, FRAME_VOICES_OFFSET + numVoices)),
+      mode: frame[7],
+    });
   }, []);
 
   useEffect(() => {
@@ -74,9 +85,9 @@ export function useVisualizerData(): SwayVisualizerData {
       return () => cancelAnimationFrame(animationFrame);
     }
 
-    addEventListener('visualizerData', handleVisualizerData);
-    return () => removeEventListener('visualizerData', handleVisualizerData);
-  }, [handleVisualizerData]);
+    addEventListener('visualizerFrames', handleVisualizerFrames);
+    return () => removeEventListener('visualizerFrames', handleVisualizerFrames);
+  }, [handleVisualizerFrames]);
 
   return data;
 }
@@ -1,6 +1,6 @@
 /**
  * JUCE WebView Bridge Utilities
- * Provides type-safe access to JUCE relay system
+ * Provides type-safe access to the JUCE WebView backend
  */
 
 declare global {
@@ -12,20 +12,6 @@ declare global {
         emitEvent: (event: string, data: any) => void;
       };
       initialisationData?: any;
-      getSliderState?: (id: string) => {
-        getNormalisedValue: () => number;
-        getScaledValue: () => number;
-        setNormalisedValue: (val: number) => void;
-        setScaledValue: (val: number) => void;
-        sliderDragStarted: () => void;
-        sliderDragEnded: () => void;
-        getProperties: () => any;
-      };
-      getToggleState?: (id: string) => {
-        getValue: () => boolean;
-        setValue: (val: boolean) => void;
-        getProperties: () => any;
-      };
     };
   }
 }
@@ -34,28 +20,6 @@ export function isInJuceWebView(): boolean {
   return typeof window.__JUCE__ !== 'undefined';
 }
 
-export function getSliderState(paramId: string) {
-  if (!isInJuceWebView() || !window.__JUCE__?.getSliderState) {
-    return null;
-  }
-  try {
-    return window.__JUCE__.getSliderState(paramId);
-  } catch {
-    return null;
-  }
-}
-
-export function getToggleState(paramId: string) {
-  if (!isInJuceWebView() || !window.__JUCE__?.getToggleState) {
-    return null;
-  }
-  try {
-    return window.__JUCE__.getToggleState(paramId);
-  } catch {
-    return null;
-  }
-}
-
 export function emitEvent(event: string, data: any = {}) {
   if (isInJuceWebView() && window.__JUCE__?.backend?.emitEvent) {
     window.__JUCE__.backend.emitEvent(event, data);
@@ -73,3 +37,47 @@ export function removeEventListener(event: string, callback: (data: any) => void
     window.__JUCE__.backend.removeEventListener(event, callback);
   }
 }
+
+/**
+ * Frames of packed Float32 values sent by the plugin as base64:
+ * a [version, stride] header followed by `count` frames of `stride` values.
+ * Returns null unless the payload holds a whole number of frames.
+ */
+export interface Float32Frames {
+  version: number;
+  stride: number;
+  count: number;
+  data: Float32Array;
+}
+
+export function readFloat32Frames(payload: unknown): Float32Frames | null {
+  if (typeof payload !== 'string' || payload.length === 0) {
+    return null;
+  }
+
+  let binary: string;
+  try {
+    binary = atob(payload);
+  } catch {
+    return null;
+  }
+
+  const bytes = new Uint8Array(binary.length);
+  for (let i = 0; i < binary.length; i++) {
+    bytes[i] = binary.charCodeAt(i);
+  }
+
+  // A truncated or padded payload would misalign every frame after it; drop it whole
+  if (bytes.length % 4 !== 0 || bytes.length < 8) {
+    return null;
+  }
+
+  const data = new Float32Array(bytes.buffer);
+  const version = data[0];
+  const stride = data[1];
+  if (!Number.isInteger(stride) || stride < 1 || (data.length - 2) % stride !== 0) {
+    return null;
+  }
+
+  return { version, stride, count: (data.length - 2) / stride, data: data.subarray(2) };
+}
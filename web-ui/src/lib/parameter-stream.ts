@@ -0,0 +1,102 @@
+/**
+ * Client side of the plugin's batched parameter channel (Source/ParameterStream.h).
+ *
+ * The plugin sends one 'parameterFrames' message per UI frame holding every
+ * parameter that changed, as [index, value] frames indexed by the table in
+ * 'parameterLayout'. Values are in each parameter's own units. Changes from the
+ * UI go back as 'parameterChange' and 'parameterGesture' events.
+ */
+import { isInJuceWebView, addEventListener, emitEvent, readFloat32Frames } from './juce-bridge';
+
+interface ParameterInfo {
+  id: string;
+  min: number;
+  max: number;
+}
+
+type Listener = (value: number) => void;
+
+const FRAME_VERSION = 1;
+
+let layout: ParameterInfo[] = [];
+const values = new Map<string, number>();
+const listeners = new Map<string, Set<Listener>>();
+const activeGestures = new Set<string>();
+let connected = false;
+
+function handleLayout(data: unknown) {
+  layout = Array.isArray(data) ? (data as ParameterInfo[]) : [];
+}
+
+function handleFrames(payload: unknown) {
+  const frames = readFloat32Frames(payload);
+  if (!frames || frames.version !== FRAME_VERSION || frames.stride < 2) {
+    return;
+  }
+
+  for (let i = 0; i < frames.count; i++) {
+    const info = layout[frames.data[i * frames.stride]];
+    // The UI owns a parameter while dragging it; the host only echoes it back
+    if (!info || activeGestures.has(info.id)) {
+      continue;
+    }
+
+    const value = frames.data[i * frames.stride + 1];
+    values.set(info.id, value);
+    listeners.get(info.id)?.forEach((listener) => listener(value));
+  }
+}
+
+function connect() {
+  if (connected || !isInJuceWebView()) {
+    return;
+  }
+
+  connected = true;
+  addEventListener('parameterLayout', handleLayout);
+  addEventListener('parameterFrames', handleFrames);
+  emitEvent('requestParameters');
+}
+
+/** Calls `listener` with the current value, if known, and on every change from the plugin */
+export function subscribeParameter(id: string, listener: Listener): () => void {
+  connect();
+
+  let set = listeners.get(id);
+  if (!set) {
+    set = new Set();
+    listeners.set(id, set);
+  }
+  set.add(listener);
+
+  const current = values.get(id);
+  if (current !== undefined) {
+    listener(current);
+  }
+
+  return () => {
+    set?.delete(listener);
+  };
+}
+
+export function setParameter(id: string, value: number) {
+  values.set(id, value);
+  emitEvent('parameterChange', { id, value });
+}
+
+export function setParameterNormalised(id: string, normalised: number): number {
+  const info = layout.find((entry) => entry.id === id);
+  const value = info ? info.min + (info.max - info.min) * normalised : normalised;
+  setParameter(id, value);
+  return value;
+}
+
+export function beginParameterGesture(id: string) {
+  activeGestures.add(id);
+  emitEvent('parameterGesture', { id, begin: true });
+}
+
+export function endParameterGesture(id: string) {
+  activeGestures.delete(id);
+  emitEvent('parameterGesture', { id, begin: false });
+}